@@ -4,6 +4,11 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "auto_monitor_ioctl.h"
 
 #define DEVICE_FILE "/dev/auto_monitor"
 #define SYSLOG_CMD "dmesg | tail -n 20"
@@ -17,6 +22,14 @@ void print_menu() {
     printf("5. Read resource_factor from Sysfs\n");
     printf("6. Read critical_alerts from Sysfs\n");
     printf("7. View kernel logs (dmesg)\n");
+    printf("8. List tracked cgroups (via /dev/%s ioctl)\n", DEVICE_FILE);
+    printf("9. Watch a PID (via ioctl)\n");
+    printf("10. Unwatch a PID (via ioctl)\n");
+    printf("11. List watched PIDs (via ioctl)\n");
+    printf("12. Publish an SLO report (via ioctl)\n");
+    printf("13. Push synthetic latencies through a shared-memory ring\n");
+    printf("14. Load a policy model blob (via ioctl)\n");
+    printf("15. Show or change thresholds and factor limits (via ioctl)\n");
     printf("0. Exit\n");
     printf("Enter choice: ");
 }
@@ -54,6 +67,315 @@ int write_sysfs_attr(const char* attr_path, const char* value) {
     return 0;
 }
 
+#define CGROUP_LIST_CAPACITY 256
+
+int list_cgroups() {
+    struct auto_monitor_cgroup_stat *stats;
+    struct auto_monitor_cgroup_list list;
+    int fd;
+
+    stats = calloc(CGROUP_LIST_CAPACITY, sizeof(*stats));
+    if (!stats) {
+        perror("Failed to allocate cgroup buffer");
+        return -1;
+    }
+
+    fd = open(DEVICE_FILE, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open device");
+        free(stats);
+        return -1;
+    }
+
+    memset(&list, 0, sizeof(list));
+    list.capacity = CGROUP_LIST_CAPACITY;
+    list.entries = (__u64)(uintptr_t)stats;
+    if (ioctl(fd, AUTO_MONITOR_IOC_CGROUP_LIST, &list) < 0) {
+        perror("Failed to list cgroups");
+        close(fd);
+        free(stats);
+        return -1;
+    }
+
+    printf("\n--- Tracked Cgroups (%u of %u) ---\n", list.count, list.total);
+    printf("%-8s %6s %12s %8s %8s %8s %6s %s\n", "id", "cpu%", "memory_kb", "psi_cpu", "psi_mem", "psi_io", "factor", "path");
+    for (__u32 i = 0; i < list.count; i++) {
+        struct auto_monitor_cgroup_stat *st = &stats[i];
+        printf("%-8llu %6u %12llu %5u.%02u %5u.%02u %5u.%02u %6u %s\n",
+               (unsigned long long)st->id, st->cpu_pct, (unsigned long long)(st->memory_bytes / 1024),
+               st->psi_cpu_some / 100, st->psi_cpu_some % 100,
+               st->psi_memory_some / 100, st->psi_memory_some % 100,
+               st->psi_io_some / 100, st->psi_io_some % 100,
+               st->resource_factor, st->path);
+    }
+
+    close(fd);
+    free(stats);
+    return 0;
+}
+
+int watch_pid(unsigned long cmd) {
+    char input_str[64];
+    __s32 pid;
+    int fd;
+
+    printf("Enter PID: ");
+    if (fgets(input_str, sizeof(input_str), stdin) == NULL) {
+        printf("Error reading input.\n");
+        return -1;
+    }
+    pid = (__s32)strtol(input_str, NULL, 10);
+    if (pid <= 0) {
+        printf("Invalid PID.\n");
+        return -1;
+    }
+
+    fd = open(DEVICE_FILE, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open device");
+        return -1;
+    }
+    if (ioctl(fd, cmd, &pid) < 0) {
+        perror(cmd == AUTO_MONITOR_IOC_WATCH_ADD ? "Failed to watch PID" : "Failed to unwatch PID");
+        close(fd);
+        return -1;
+    }
+    printf("PID %d %s.\n", pid, cmd == AUTO_MONITOR_IOC_WATCH_ADD ? "is now watched" : "is no longer watched");
+    close(fd);
+    return 0;
+}
+
+#define WATCH_LIST_CAPACITY 64
+
+int list_watched_pids() {
+    struct auto_monitor_watch_stat stats[WATCH_LIST_CAPACITY];
+    struct auto_monitor_watch_list list;
+    int fd;
+
+    fd = open(DEVICE_FILE, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open device");
+        return -1;
+    }
+
+    memset(&list, 0, sizeof(list));
+    list.capacity = WATCH_LIST_CAPACITY;
+    list.entries = (__u64)(uintptr_t)stats;
+    if (ioctl(fd, AUTO_MONITOR_IOC_WATCH_LIST, &list) < 0) {
+        perror("Failed to list watched PIDs");
+        close(fd);
+        return -1;
+    }
+
+    printf("\n--- Watched PIDs (%u) ---\n", list.total);
+    printf("%-8s %-16s %5s %6s %11s %9s %9s\n", "pid", "comm", "alive", "cpu%", "starvation%", "nvcsw/s", "nivcsw/s");
+    for (__u32 i = 0; i < list.count; i++) {
+        struct auto_monitor_watch_stat *st = &stats[i];
+        printf("%-8d %-16s %5u %6u %11u %9u %9u\n", st->pid, st->comm, st->alive, st->cpu_pct,
+               st->starvation_pct, st->nvcsw_ps, st->nivcsw_ps);
+    }
+
+    close(fd);
+    return 0;
+}
+
+int report_slo() {
+    struct auto_monitor_slo_report report;
+    char input_str[64];
+    unsigned long long requests;
+    unsigned int window_ms, p50_us, p99_us;
+    int fd;
+
+    memset(&report, 0, sizeof(report));
+    printf("Enter reporter name (empty = this PID): ");
+    if (fgets(input_str, sizeof(input_str), stdin) == NULL) {
+        printf("Error reading input.\n");
+        return -1;
+    }
+    input_str[strcspn(input_str, "\n")] = 0;
+    strncpy(report.name, input_str, sizeof(report.name) - 1);
+
+    printf("Enter window_ms p50_us p99_us requests: ");
+    if (fgets(input_str, sizeof(input_str), stdin) == NULL ||
+        sscanf(input_str, "%u %u %u %llu", &window_ms, &p50_us, &p99_us, &requests) != 4) {
+        printf("Invalid report.\n");
+        return -1;
+    }
+    report.window_ms = window_ms;
+    report.p50_us = p50_us;
+    report.p99_us = p99_us;
+    report.requests = requests;
+
+    fd = open(DEVICE_FILE, O_WRONLY);
+    if (fd < 0) {
+        perror("Failed to open device");
+        return -1;
+    }
+    if (ioctl(fd, AUTO_MONITOR_IOC_SLO_REPORT, &report) < 0) {
+        perror("Failed to publish SLO report");
+        close(fd);
+        return -1;
+    }
+    printf("SLO report published.\n");
+    close(fd);
+    return 0;
+}
+
+#define RING_DEMO_CAPACITY 4096
+#define RING_DEMO_RECORDS 100000
+
+int ring_demo() {
+    struct auto_monitor_ring_create req;
+    struct auto_monitor_ring_header *hdr;
+    unsigned long pushed = 0;
+    int fd;
+
+    fd = open(DEVICE_FILE, O_RDWR);
+    if (fd < 0) {
+        perror("Failed to open device");
+        return -1;
+    }
+
+    memset(&req, 0, sizeof(req));
+    strncpy(req.name, "user_app_ring", sizeof(req.name) - 1);
+    req.capacity = RING_DEMO_CAPACITY;
+    if (ioctl(fd, AUTO_MONITOR_IOC_RING_CREATE, &req) < 0) {
+        perror("Failed to create ring");
+        close(fd);
+        return -1;
+    }
+
+    hdr = mmap(NULL, req.mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED) {
+        perror("Failed to mmap ring");
+        close(fd);
+        return -1;
+    }
+
+    // Plain stores, no syscalls; back off briefly whenever the kernel flags backpressure
+    for (int i = 0; i < RING_DEMO_RECORDS; i++) {
+        if (__atomic_load_n(&hdr->flags, __ATOMIC_RELAXED) & AUTO_MONITOR_RING_BACKPRESSURE)
+            usleep(1000);
+        if (auto_monitor_ring_push(hdr, AUTO_MONITOR_METRIC_LATENCY_US, 500 + rand() % 20000) == 0)
+            pushed++;
+    }
+
+    // Give the work handler a window to drain and report
+    sleep(2);
+    printf("Pushed %lu records, overflow %llu, consumed %llu, invalid %llu, backpressure %s\n",
+           pushed, (unsigned long long)hdr->overflow, (unsigned long long)hdr->consumed,
+           (unsigned long long)hdr->invalid, (hdr->flags & AUTO_MONITOR_RING_BACKPRESSURE) ? "on" : "off");
+    printf("See /sys/kernel/auto_monitor/slo/reporters for the \"user_app_ring\" aggregate.\n");
+
+    munmap(hdr, req.mmap_size);
+    close(fd);
+    return 0;
+}
+
+int load_model() {
+    struct auto_monitor_model_load req;
+    char path[256];
+    char *blob = NULL;
+    long size = 0;
+    FILE *f;
+    int fd, ret = -1;
+
+    printf("Enter model file path (empty = unload): ");
+    if (fgets(path, sizeof(path), stdin) == NULL) {
+        printf("Error reading input.\n");
+        return -1;
+    }
+    path[strcspn(path, "\n")] = 0;
+
+    if (path[0]) {
+        f = fopen(path, "rb");
+        if (!f) {
+            perror("Failed to open model file");
+            return -1;
+        }
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        rewind(f);
+        blob = malloc(size > 0 ? size : 1);
+        if (!blob || size <= 0 || fread(blob, 1, size, f) != (size_t)size) {
+            printf("Failed to read model file.\n");
+            free(blob);
+            fclose(f);
+            return -1;
+        }
+        fclose(f);
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.data = (uintptr_t)blob;
+    req.size = size;
+
+    fd = open(DEVICE_FILE, O_WRONLY);
+    if (fd < 0) {
+        perror("Failed to open device");
+        free(blob);
+        return -1;
+    }
+    if (ioctl(fd, AUTO_MONITOR_IOC_MODEL_LOAD, &req) < 0) {
+        perror("Model rejected");
+    } else {
+        printf(size ? "Model loaded, select it with: echo model > /sys/kernel/auto_monitor/policy/active\n"
+                    : "Model unloaded.\n");
+        ret = 0;
+    }
+    close(fd);
+    free(blob);
+    return ret;
+}
+
+int configure() {
+    struct auto_monitor_config cfg;
+    char input_str[64];
+    unsigned int high, low, max_factor, initial;
+    int fd, ret = -1;
+
+    fd = open(DEVICE_FILE, O_RDWR);
+    if (fd < 0) {
+        perror("Failed to open device");
+        return -1;
+    }
+    memset(&cfg, 0, sizeof(cfg));
+    if (ioctl(fd, AUTO_MONITOR_IOC_CONFIG_GET, &cfg) < 0) {
+        perror("Failed to read configuration");
+        close(fd);
+        return -1;
+    }
+    printf("Generation %llu: band %u-%u%%, factor 1-%u, initial %u\n", (unsigned long long)cfg.generation,
+           cfg.low_threshold, cfg.high_threshold, cfg.max_factor, cfg.initial_factor);
+
+    printf("Enter high_threshold low_threshold max_factor initial_factor (empty = keep): ");
+    if (fgets(input_str, sizeof(input_str), stdin) == NULL || input_str[0] == '\n') {
+        close(fd);
+        return 0;
+    }
+    if (sscanf(input_str, "%u %u %u %u", &high, &low, &max_factor, &initial) != 4) {
+        printf("Invalid configuration.\n");
+        close(fd);
+        return -1;
+    }
+
+    // All four fields are validated and published together
+    cfg.set = AUTO_MONITOR_CONFIG_HIGH_THRESHOLD | AUTO_MONITOR_CONFIG_LOW_THRESHOLD |
+              AUTO_MONITOR_CONFIG_MAX_FACTOR | AUTO_MONITOR_CONFIG_INITIAL_FACTOR;
+    cfg.high_threshold = high;
+    cfg.low_threshold = low;
+    cfg.max_factor = max_factor;
+    cfg.initial_factor = initial;
+    if (ioctl(fd, AUTO_MONITOR_IOC_CONFIG_SET, &cfg) < 0) {
+        perror("Configuration rejected");
+    } else {
+        printf("Generation %llu now in effect.\n", (unsigned long long)cfg.generation);
+        ret = 0;
+    }
+    close(fd);
+    return ret;
+}
+
 int main() {
     int choice;
     int fd;
@@ -155,6 +477,38 @@ int main() {
                 system(SYSLOG_CMD);
                 break;
 
+            case 8: // List cgroups via ioctl
+                list_cgroups();
+                break;
+
+            case 9: // Register a PID via ioctl
+                watch_pid(AUTO_MONITOR_IOC_WATCH_ADD);
+                break;
+
+            case 10: // Unregister a PID via ioctl
+                watch_pid(AUTO_MONITOR_IOC_WATCH_DEL);
+                break;
+
+            case 11: // List watched PIDs via ioctl
+                list_watched_pids();
+                break;
+
+            case 12: // Publish an SLO report via ioctl
+                report_slo();
+                break;
+
+            case 13: // Shared-memory ring producer demo
+                ring_demo();
+                break;
+
+            case 14: // Load or unload a policy model via ioctl
+                load_model();
+                break;
+
+            case 15: // Runtime configuration via ioctl
+                configure();
+                break;
+
             case 0:
                 printf("Exiting application.\n");
                 return 0;
@@ -12,6 +12,42 @@
 #include <linux/uaccess.h>
 #include <linux/sysfs.h>
 #include <linux/kobject.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/namei.h>
+#include <linux/math64.h>
+#include <linux/netdevice.h>
+#include <linux/rtnetlink.h>
+#include <linux/ethtool.h>
+#include <linux/kernel_stat.h>
+#include <linux/interrupt.h>
+#include <linux/mmzone.h>
+#include <linux/vmstat.h>
+#include <linux/perf_event.h>
+#include <linux/cpu.h>
+#include <linux/cpuhotplug.h>
+#include <linux/cgroup.h>
+#include <linux/memcontrol.h>
+#include <linux/psi.h>
+#include <linux/hashtable.h>
+#include <linux/sched/loadavg.h>
+#include <linux/sched/signal.h>
+#include <linux/sched/task.h>
+#include <linux/sched/mm.h>
+#include <linux/sched/clock.h>
+#include <linux/pid.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+#include <linux/log2.h>
+#include <linux/int_sqrt.h>
+#include <linux/ctype.h>
+#include <linux/bpf.h>
+#include <linux/bpf_verifier.h>
+#include <linux/btf.h>
+
+#include "auto_monitor_ioctl.h"
+#include "auto_monitor_policy.h"
+#include <net/net_namespace.h>
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Tharun Ganeshram");
@@ -19,113 +55,5953 @@ MODULE_DESCRIPTION("Autonomous System Health Monitor & Dynamic Resource Adjuster
 MODULE_VERSION("1.0");
 
 
-#define MAX_WORKLOAD_LEVEL 100
-#define MAX_RESOURCE_FACTOR 10
+#define MAX_WORKLOAD_LEVEL 100
+// Defaults of the runtime configuration (see Runtime Configuration)
+#define DEFAULT_MAX_RESOURCE_FACTOR 10
+#define DEFAULT_INITIAL_RESOURCE_FACTOR 5
+#define DEFAULT_WORKLOAD_HIGH_THRESHOLD 80
+#define DEFAULT_WORKLOAD_LOW_THRESHOLD 20
+
+// Global data structure for tracking system data
+struct auto_monitor_data {
+    ktime_t last_check_time;
+    unsigned long current_sim_workload_level;   // 0-MAX_WORKLOAD_LEVEL (simulated %)
+    unsigned long resource_allocation_factor;   // 1-max_factor (simulated resource units)
+    atomic_t critical_alerts;                   // Atomic counter for critical events
+    atomic_t timer_ticks;                       // To count timer firings
+    unsigned long simulated_gpu_temp;           // Simulated temperature (degrees Celsius)
+    unsigned long simulated_memory_pressure;    // 0-MAX_MEMORY_PRESSURE (simulated %)
+    ktime_t last_source_sample;                 // Last time the metric sources were sampled
+    unsigned long io_utilization;               // 0-100 (% busy of the busiest monitored disk)
+    unsigned long net_utilization;              // 0-100 (% of link speed of the busiest interface)
+    unsigned long irq_load;                     // 0-100 (% hardirq+softirq time of the busiest CPU)
+    unsigned long steal_time;                   // 0-100 (% of CPU time stolen by the hypervisor, averaged over CPUs)
+    unsigned long reclaim_pressure;             // 0-100 (tightest zone between high and min watermark, or the reclaim stall rate)
+    unsigned long watch_starvation;             // 0-100 (% run-queue wait of the most starved watched process)
+    unsigned long slo_p99_us;                   // Worst p99 latency across fresh SLO reporters (0 = none)
+    unsigned long slo_throughput;               // Requests/s summed over fresh SLO reporters
+};
+static struct auto_monitor_data monitor_state;
+
+// Synchronization
+static DEFINE_SPINLOCK(monitor_data_spinlock); // Protects monitor_state fields from access by HRTimer callback (atomic context)
+static struct mutex monitor_config_mutex;     // Protects monitor_state fields from access by workqueue and user-space (process context)
+
+// HRTimer
+static struct hrtimer monitor_hrtimer;
+#define HRTIMER_INTERVAL_MS 100
+
+// Workqueue
+static struct workqueue_struct *monitor_wq;
+static struct work_struct monitor_work;
+
+// Character Device
+static int major_number;
+static struct class* auto_monitor_class = NULL;
+static struct device* auto_monitor_device = NULL;
+#define DEVICE_NAME "auto_monitor"
+#define CLASS_NAME "auto_monitor_class"
+#define SUMMARY_BUF_SIZE PAGE_SIZE
+
+// Sysfs Attributes
+static ssize_t workload_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
+static ssize_t workload_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count);
+static ssize_t resource_factor_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
+static ssize_t alerts_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
+
+static struct kobj_attribute workload_attribute = __ATTR(current_workload, 0664, workload_show, workload_store);    // Read/Write
+static struct kobj_attribute resource_attribute = __ATTR(resource_factor, 0444, resource_factor_show, NULL);        // Read-only
+static struct kobj_attribute alerts_attribute = __ATTR(critical_alerts, 0444, alerts_show, NULL);                   // Read-only
+
+static struct attribute *auto_monitor_attrs[] = {
+    &workload_attribute.attr,
+    &resource_attribute.attr,
+    &alerts_attribute.attr,
+    NULL,
+};
+
+static struct attribute_group auto_monitor_attr_group = {
+    .attrs = auto_monitor_attrs,
+};
+
+static struct kobject *auto_monitor_kobj;
+
+// Function Prototypes
+static int auto_monitor_open(struct inode *inode, struct file *file);
+static int auto_monitor_release(struct inode *inode, struct file *file);
+static ssize_t auto_monitor_read(struct file *file, char __user *buf, size_t len, loff_t *offset);
+static ssize_t auto_monitor_write(struct file *file, const char __user *buf, size_t len, loff_t *offset);
+static long auto_monitor_ioctl(struct file *file, unsigned int cmd, unsigned long arg);
+static int auto_monitor_mmap(struct file *file, struct vm_area_struct *vma);
+
+// Map use-space file system calls to functions
+static struct file_operations fops = {
+    .owner = THIS_MODULE,
+    .open = auto_monitor_open,
+    .release = auto_monitor_release,
+    .read = auto_monitor_read,
+    .write = auto_monitor_write,
+    .unlocked_ioctl = auto_monitor_ioctl,
+    .compat_ioctl = compat_ptr_ioctl,
+    .mmap = auto_monitor_mmap,
+};
+
+// Runtime Configuration
+// The workload band, the factor ceiling and the initial factor live in one immutable struct published with
+// RCU. Readers (the work handler, which hands it to the policies through monitor_inputs, and the cgroup
+// source) copy it under rcu_read_lock and never wait. Writers serialize on adjust_cfg_mutex, validate a
+// modified copy as a whole, swap the pointer and free the old copy after a grace period. Changes that
+// touch several fields go through AUTO_MONITOR_IOC_CONFIG_SET so they are checked and published together.
+#define ADJUST_CONFIG_ALL (AUTO_MONITOR_CONFIG_HIGH_THRESHOLD | AUTO_MONITOR_CONFIG_LOW_THRESHOLD | \
+                           AUTO_MONITOR_CONFIG_MAX_FACTOR | AUTO_MONITOR_CONFIG_INITIAL_FACTOR)
+
+struct adjust_config {
+    unsigned long high_threshold;
+    unsigned long low_threshold;
+    unsigned long max_factor;
+    unsigned long initial_factor;
+    u64 generation;
+    struct rcu_head rcu;
+};
+
+// Built-in defaults, in effect until the first change (never freed)
+static struct adjust_config adjust_cfg_default = {
+    .high_threshold = DEFAULT_WORKLOAD_HIGH_THRESHOLD,
+    .low_threshold = DEFAULT_WORKLOAD_LOW_THRESHOLD,
+    .max_factor = DEFAULT_MAX_RESOURCE_FACTOR,
+    .initial_factor = DEFAULT_INITIAL_RESOURCE_FACTOR,
+};
+static struct adjust_config __rcu *adjust_cfg = &adjust_cfg_default;
+static DEFINE_MUTEX(adjust_cfg_mutex);
+
+// The machine-wide factor starts here at load; later changes of initial_factor only affect new cgroups
+static unsigned long initial_factor = DEFAULT_INITIAL_RESOURCE_FACTOR;
+module_param(initial_factor, ulong, 0444);
+MODULE_PARM_DESC(initial_factor, "Resource factor at load and for newly tracked cgroups (1 to 10)");
+
+// Copy of the configuration in effect (any context)
+static void adjust_config_get(struct adjust_config *out)
+{
+    rcu_read_lock();
+    *out = *rcu_dereference(adjust_cfg);
+    rcu_read_unlock();
+}
+
+static void adjust_config_export(const struct adjust_config *c, struct auto_monitor_config *out)
+{
+    out->high_threshold = c->high_threshold;
+    out->low_threshold = c->low_threshold;
+    out->max_factor = c->max_factor;
+    out->initial_factor = c->initial_factor;
+    out->generation = c->generation;
+}
+
+// Apply the fields selected in req->set and publish the result if it is valid as a whole. On return req
+// holds the configuration in effect.
+static int adjust_config_update(struct auto_monitor_config *req)
+{
+    struct adjust_config *c, *old;
+
+    if (req->set & ~ADJUST_CONFIG_ALL)
+        return -EINVAL;
+    c = kmalloc(sizeof(*c), GFP_KERNEL);
+    if (!c)
+        return -ENOMEM;
+
+    mutex_lock(&adjust_cfg_mutex);
+    old = rcu_dereference_protected(adjust_cfg, lockdep_is_held(&adjust_cfg_mutex));
+    *c = *old;
+    if (req->set & AUTO_MONITOR_CONFIG_HIGH_THRESHOLD)
+        c->high_threshold = req->high_threshold;
+    if (req->set & AUTO_MONITOR_CONFIG_LOW_THRESHOLD)
+        c->low_threshold = req->low_threshold;
+    if (req->set & AUTO_MONITOR_CONFIG_MAX_FACTOR)
+        c->max_factor = req->max_factor;
+    if (req->set & AUTO_MONITOR_CONFIG_INITIAL_FACTOR)
+        c->initial_factor = req->initial_factor;
+
+    if (!req->set || c->low_threshold >= c->high_threshold || c->high_threshold > MAX_WORKLOAD_LEVEL ||
+        !c->initial_factor || c->initial_factor > c->max_factor || c->max_factor > AUTO_MONITOR_FACTOR_LIMIT) {
+        adjust_config_export(old, req);
+        mutex_unlock(&adjust_cfg_mutex);
+        kfree(c);
+        return req->set ? -EINVAL : 0;
+    }
+    c->generation = old->generation + 1;
+    rcu_assign_pointer(adjust_cfg, c);
+    adjust_config_export(c, req);
+    mutex_unlock(&adjust_cfg_mutex);
+
+    if (old != &adjust_cfg_default)
+        kfree_rcu(old, rcu);
+    printk(KERN_INFO "%s: Configuration generation %llu: band %lu-%lu%%, factor 1-%lu, initial %lu\n", DEVICE_NAME,
+           c->generation, c->low_threshold, c->high_threshold, c->max_factor, c->initial_factor);
+    return 0;
+}
+
+// ioctl: AUTO_MONITOR_IOC_CONFIG_GET
+static long config_ioctl_get(struct auto_monitor_config __user *uarg)
+{
+    struct auto_monitor_config out = {};
+    struct adjust_config c;
+
+    adjust_config_get(&c);
+    adjust_config_export(&c, &out);
+    if (copy_to_user(uarg, &out, sizeof(out)))
+        return -EFAULT;
+    return 0;
+}
+
+// ioctl: AUTO_MONITOR_IOC_CONFIG_SET
+static long config_ioctl_set(struct auto_monitor_config __user *uarg)
+{
+    struct auto_monitor_config req;
+    int ret;
+
+    if (copy_from_user(&req, uarg, sizeof(req)))
+        return -EFAULT;
+    ret = adjust_config_update(&req);
+    if (ret)
+        return ret;
+    if (copy_to_user(uarg, &req, sizeof(req)))
+        return -EFAULT;
+    return 0;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/config/
+// One field per attribute, each write is validated against the other fields in effect
+struct config_attr {
+    struct kobj_attribute attr;
+    u32 field;                  // AUTO_MONITOR_CONFIG_* bit
+    size_t offset;              // Of the field in struct auto_monitor_config
+};
+
+static ssize_t config_attr_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct config_attr *a = container_of(attr, struct config_attr, attr);
+    struct auto_monitor_config out = {};
+    struct adjust_config c;
+
+    adjust_config_get(&c);
+    adjust_config_export(&c, &out);
+    return sprintf(buf, "%u\n", *(u32 *)((char *)&out + a->offset));
+}
+
+static ssize_t config_attr_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct config_attr *a = container_of(attr, struct config_attr, attr);
+    struct auto_monitor_config req = { .set = a->field };
+    int ret;
+
+    if (kstrtou32(buf, 10, (u32 *)((char *)&req + a->offset)) < 0)
+        return -EINVAL;
+    ret = adjust_config_update(&req);
+    return ret ? ret : count;
+}
+
+static ssize_t config_generation_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct adjust_config c;
+
+    adjust_config_get(&c);
+    return sprintf(buf, "%llu\n", c.generation);
+}
+
+#define CONFIG_ATTR(_name, _field)                                                      \
+    static struct config_attr _name##_config = {                                        \
+        .attr = __ATTR(_name, 0664, config_attr_show, config_attr_store),               \
+        .field = (_field),                                                              \
+        .offset = offsetof(struct auto_monitor_config, _name),                          \
+    }
+
+// Read/Write
+CONFIG_ATTR(high_threshold, AUTO_MONITOR_CONFIG_HIGH_THRESHOLD);
+CONFIG_ATTR(low_threshold, AUTO_MONITOR_CONFIG_LOW_THRESHOLD);
+CONFIG_ATTR(max_factor, AUTO_MONITOR_CONFIG_MAX_FACTOR);
+CONFIG_ATTR(initial_factor, AUTO_MONITOR_CONFIG_INITIAL_FACTOR);
+static struct kobj_attribute config_generation_attribute = __ATTR(generation, 0444, config_generation_show, NULL);  // Read-only
+
+static struct attribute *config_attrs[] = {
+    &high_threshold_config.attr.attr,
+    &low_threshold_config.attr.attr,
+    &max_factor_config.attr.attr,
+    &initial_factor_config.attr.attr,
+    &config_generation_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group config_attr_group = {
+    .name = "config",
+    .attrs = config_attrs,
+};
+
+// Critical Alerts (process context, monitor_config_mutex held)
+// Every critical alert bumps the counter and replaces the last alert record, which carries a snapshot of
+// the task tracker's top-N tasks when the tracker is enabled.
+#define TOP_TASKS_N 10
+#define ALERT_REASON_LEN 64
+
+struct top_task {
+    pid_t pid;
+    char comm[TASK_COMM_LEN];
+    u64 cpu_delta_ns;           // CPU time consumed over the last window (all threads)
+    unsigned long cpu_pct;      // cpu_delta_ns as % of one CPU (can exceed 100)
+    unsigned long rss_kb;
+};
+
+struct alert_record {
+    ktime_t time;
+    char reason[ALERT_REASON_LEN];
+    unsigned long value;        // Signal value that triggered the alert
+    unsigned long resource_factor;
+    int nr_cpu_tasks, nr_rss_tasks;
+    struct top_task cpu_tasks[TOP_TASKS_N];    // Top tasks by CPU delta, highest first
+    struct top_task rss_tasks[TOP_TASKS_N];    // Top tasks by RSS, highest first
+};
+
+// Filled by the task tracker source, sorted highest first
+static struct top_task top_cpu_tasks[TOP_TASKS_N];
+static struct top_task top_rss_tasks[TOP_TASKS_N];
+static int top_cpu_count, top_rss_count;
+
+static struct alert_record last_alert;
+
+static void monitor_raise_alert(const char *reason, unsigned long value)
+{
+    atomic_inc(&monitor_state.critical_alerts);
+
+    last_alert.time = ktime_get();
+    strscpy(last_alert.reason, reason, sizeof(last_alert.reason));
+    last_alert.value = value;
+    last_alert.resource_factor = monitor_state.resource_allocation_factor;
+    last_alert.nr_cpu_tasks = top_cpu_count;
+    last_alert.nr_rss_tasks = top_rss_count;
+    memcpy(last_alert.cpu_tasks, top_cpu_tasks, sizeof(top_cpu_tasks));
+    memcpy(last_alert.rss_tasks, top_rss_tasks, sizeof(top_rss_tasks));
+}
+
+// Metric Sources (process context)
+// Each source is sampled from the workqueue handler with monitor_config_mutex held,
+// publishes its own Sysfs group under /sys/kernel/auto_monitor/ and appends
+// summary lines to /dev/auto_monitor reads.
+struct monitor_source {
+    const char *name;
+    int (*init)(void);
+    void (*exit)(void);
+    void (*sample)(ktime_t now);
+    int (*summary)(char *buf, size_t size);
+    const struct attribute_group *attr_group;
+};
+
+// Minimum spacing between source samples, so user-triggered work runs don't compute rates over tiny intervals
+#define SOURCE_MIN_INTERVAL_MS (HRTIMER_INTERVAL_MS / 2)
+
+// Read a whole procfs file into a kmalloc'd, NUL-terminated buffer (caller frees)
+static char *source_read_file(const char *path, size_t max_len)
+{
+    struct file *filp;
+    char *buf;
+    loff_t pos = 0;
+    ssize_t ret;
+    size_t total = 0;
+
+    buf = kmalloc(max_len + 1, GFP_KERNEL);
+    if (!buf)
+        return NULL;
+
+    filp = filp_open(path, O_RDONLY, 0);
+    if (IS_ERR(filp)) {
+        kfree(buf);
+        return NULL;
+    }
+
+    // procfs files can return short reads, keep going until EOF or buffer full
+    while (total < max_len) {
+        ret = kernel_read(filp, buf + total, max_len - total, &pos);
+        if (ret <= 0)
+            break;
+        total += ret;
+    }
+    filp_close(filp, NULL);
+
+    buf[total] = '\0';
+    return buf;
+}
+
+// Block Device IO Source
+// Walks /proc/diskstats and derives per-disk rates from the counter deltas between samples.
+#define IO_MAX_DEVICES 32
+#define IO_FILTER_LEN 256
+#define IO_DISKSTATS_MAX_LEN (16 * PAGE_SIZE)
+#define SECTOR_SIZE_BYTES 512
+
+struct io_disk {
+    char name[32];
+    bool is_disk;               // Whole disk (has /sys/block/<name>), only looked up while the filter is empty
+    bool seen;                  // Present in the current sample
+    bool primed;                // Has a previous sample to diff against
+    // Raw counters from the last sample
+    u64 reads, writes;
+    u64 sectors_read, sectors_written;
+    u64 read_ms, write_ms;      // Total time spent on completed requests
+    u64 io_ticks_ms;            // Time the device had requests in flight
+    // Derived over the last interval
+    unsigned long iops;
+    unsigned long read_bps, write_bps;
+    unsigned long in_flight;
+    unsigned long avg_service_us;
+    unsigned long util;         // 0-100 (% of interval busy)
+};
+
+static struct io_disk io_disks[IO_MAX_DEVICES];
+static int io_disk_count;
+static char io_device_filter[IO_FILTER_LEN];   // Comma-separated names, trailing '*' matches a prefix; empty = all whole disks
+static ktime_t io_last_sample;
+
+static bool io_name_matches(const char *name, const char *pattern, size_t pattern_len)
+{
+    if (pattern_len && pattern[pattern_len - 1] == '*')
+        return strncmp(name, pattern, pattern_len - 1) == 0;
+    return strlen(name) == pattern_len && strncmp(name, pattern, pattern_len) == 0;
+}
+
+static bool io_device_selected(const struct io_disk *disk)
+{
+    const char *p = io_device_filter;
+
+    if (!*p)
+        return disk->is_disk;
+
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? end - p : strlen(p);
+
+        if (len && io_name_matches(disk->name, p, len))
+            return true;
+        if (!end)
+            break;
+        p = end + 1;
+    }
+    return false;
+}
+
+// Returns the slot tracking name, or NULL when the device is not selected (or the table is full).
+// Unselected devices never take a slot, so partitions and loop devices can't crowd out the disks.
+static struct io_disk *io_find_or_add(const char *name)
+{
+    char sys_path[64];
+    struct path path;
+    struct io_disk *disk;
+    int i;
+
+    for (i = 0; i < io_disk_count; i++) {
+        if (strcmp(io_disks[i].name, name) == 0)
+            return &io_disks[i];
+    }
+    if (io_disk_count >= IO_MAX_DEVICES)
+        return NULL;
+
+    disk = &io_disks[io_disk_count];
+    memset(disk, 0, sizeof(*disk));
+    strscpy(disk->name, name, sizeof(disk->name));
+
+    // Only whole disks have a /sys/block entry, checked when an untracked device shows up with no filter set
+    if (!*io_device_filter) {
+        snprintf(sys_path, sizeof(sys_path), "/sys/block/%s", name);
+        if (kern_path(sys_path, LOOKUP_FOLLOW, &path) == 0) {
+            disk->is_disk = true;
+            path_put(&path);
+        }
+    }
+    if (!io_device_selected(disk))
+        return NULL;
+
+    io_disk_count++;
+    return disk;
+}
+
+static void io_source_sample(ktime_t now)
+{
+    char *buf, *line, *cursor;
+    s64 elapsed_ms = ktime_ms_delta(now, io_last_sample);
+    unsigned long busiest = 0;
+    int i, j;
+
+    buf = source_read_file("/proc/diskstats", IO_DISKSTATS_MAX_LEN);
+    if (!buf)
+        return;
+
+    for (i = 0; i < io_disk_count; i++)
+        io_disks[i].seen = false;
+
+    cursor = buf;
+    while ((line = strsep(&cursor, "\n")) != NULL) {
+        unsigned int major, minor;
+        char name[32];
+        u64 reads, read_sectors, read_ms, writes, write_sectors, write_ms, io_ticks;
+        unsigned long in_flight;
+        struct io_disk *disk;
+        u64 ios;
+
+        // major minor name reads merged sectors ms writes merged sectors ms in_flight io_ticks ...
+        if (sscanf(line, "%u %u %31s %llu %*u %llu %llu %llu %*u %llu %llu %lu %llu",
+                   &major, &minor, name, &reads, &read_sectors, &read_ms,
+                   &writes, &write_sectors, &write_ms, &in_flight, &io_ticks) != 11)
+            continue;
+
+        disk = io_find_or_add(name);
+        if (!disk)
+            continue;
+        disk->seen = true;
+        disk->in_flight = in_flight;
+
+        if (disk->primed && elapsed_ms > 0) {
+            ios = (reads - disk->reads) + (writes - disk->writes);
+            disk->iops = div64_u64(ios * MSEC_PER_SEC, elapsed_ms);
+            disk->read_bps = div64_u64((read_sectors - disk->sectors_read) * SECTOR_SIZE_BYTES * MSEC_PER_SEC, elapsed_ms);
+            disk->write_bps = div64_u64((write_sectors - disk->sectors_written) * SECTOR_SIZE_BYTES * MSEC_PER_SEC, elapsed_ms);
+            disk->avg_service_us = ios ? div64_u64(((read_ms - disk->read_ms) + (write_ms - disk->write_ms)) * USEC_PER_MSEC, ios) : 0;
+            disk->util = min_t(u64, div64_u64((io_ticks - disk->io_ticks_ms) * 100, elapsed_ms), 100);
+        }
+
+        disk->reads = reads;
+        disk->writes = writes;
+        disk->sectors_read = read_sectors;
+        disk->sectors_written = write_sectors;
+        disk->read_ms = read_ms;
+        disk->write_ms = write_ms;
+        disk->io_ticks_ms = io_ticks;
+        disk->primed = true;
+    }
+    kfree(buf);
+
+    // Reclaim the slots of devices that disappeared (hot-unplug) or that the filter no longer selects,
+    // and find the busiest remaining disk
+    for (i = 0, j = 0; i < io_disk_count; i++) {
+        if (!io_disks[i].seen || !io_device_selected(&io_disks[i]))
+            continue;
+        if (io_disks[i].util > busiest)
+            busiest = io_disks[i].util;
+        if (i != j)
+            io_disks[j] = io_disks[i];
+        j++;
+    }
+    io_disk_count = j;
+
+    io_last_sample = now;
+    monitor_state.io_utilization = busiest;
+}
+
+static int io_source_summary(char *buf, size_t size)
+{
+    unsigned long iops = 0, read_bps = 0, write_bps = 0, in_flight = 0;
+    int i;
+
+    for (i = 0; i < io_disk_count; i++) {
+        if (!io_device_selected(&io_disks[i]))
+            continue;
+        iops += io_disks[i].iops;
+        read_bps += io_disks[i].read_bps;
+        write_bps += io_disks[i].write_bps;
+        in_flight += io_disks[i].in_flight;
+    }
+
+    return scnprintf(buf, size, "IO: %lu IOPS, Read %lu KiB/s, Write %lu KiB/s, In-Flight %lu, Busiest Disk %lu%%\n",
+                     iops, read_bps / 1024, write_bps / 1024, in_flight, monitor_state.io_utilization);
+}
+
+static void io_source_exit(void)
+{
+    io_disk_count = 0;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/io/
+static ssize_t io_devices_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len;
+    mutex_lock(&monitor_config_mutex);
+    len = sprintf(buf, "%s\n", io_device_filter);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t io_devices_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    char filter[IO_FILTER_LEN];
+
+    if (count >= IO_FILTER_LEN)
+        return -EINVAL;
+    strscpy(filter, buf, sizeof(filter));
+
+    mutex_lock(&monitor_config_mutex);
+    strscpy(io_device_filter, strim(filter), sizeof(io_device_filter));
+    mutex_unlock(&monitor_config_mutex);
+
+    printk(KERN_INFO "%s: IO device filter set to \"%s\"\n", DEVICE_NAME, strim(filter));
+    return count;
+}
+
+static ssize_t io_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "device iops read_bps write_bps in_flight svc_us util%%\n");
+    for (i = 0; i < io_disk_count; i++) {
+        struct io_disk *disk = &io_disks[i];
+        if (!io_device_selected(disk))
+            continue;
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %lu %lu %lu %lu %lu %lu\n",
+                         disk->name, disk->iops, disk->read_bps, disk->write_bps,
+                         disk->in_flight, disk->avg_service_us, disk->util);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t io_utilization_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long util;
+    mutex_lock(&monitor_config_mutex);
+    util = monitor_state.io_utilization;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", util);
+}
+
+static struct kobj_attribute io_devices_attribute = __ATTR(devices, 0664, io_devices_show, io_devices_store);        // Read/Write
+static struct kobj_attribute io_stats_attribute = __ATTR(stats, 0444, io_stats_show, NULL);                         // Read-only
+static struct kobj_attribute io_utilization_attribute = __ATTR(utilization, 0444, io_utilization_show, NULL);       // Read-only
+
+static struct attribute *io_attrs[] = {
+    &io_devices_attribute.attr,
+    &io_stats_attribute.attr,
+    &io_utilization_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group io_attr_group = {
+    .name = "io",
+    .attrs = io_attrs,
+};
+
+static struct monitor_source io_source = {
+    .name = "io",
+    .exit = io_source_exit,
+    .sample = io_source_sample,
+    .summary = io_source_summary,
+    .attr_group = &io_attr_group,
+};
+
+// Network Device Source
+// Walks the network devices of the initial namespace and derives per-interface rates from dev_get_stats() deltas.
+#define NET_MAX_DEVICES 32
+
+struct net_iface {
+    char name[IFNAMSIZ];
+    int ifindex;
+    bool seen;                  // Present in the current sample
+    bool primed;                // Has a previous sample to diff against
+    u32 speed_mbps;             // Link speed, 0 if unknown (loopback, most virtual devices)
+    // Raw counters from the last sample
+    u64 rx_packets, tx_packets;
+    u64 rx_bytes, tx_bytes;
+    u64 drops, errors;
+    // Derived over the last interval
+    unsigned long rx_pps, tx_pps;
+    unsigned long rx_bps, tx_bps;
+    unsigned long drops_ps, errors_ps;
+    unsigned long util;         // 0-100 (% of link speed, busiest direction), 0 if speed unknown
+};
+
+static struct net_iface net_ifaces[NET_MAX_DEVICES];
+static int net_iface_count;
+static ktime_t net_last_sample;
+
+// Link speed needs the RTNL lock, so it is only queried when an interface first appears
+static u32 net_link_speed(int ifindex)
+{
+    struct ethtool_link_ksettings cmd;
+    struct net_device *dev;
+    u32 speed = 0;
+
+    rtnl_lock();
+    dev = __dev_get_by_index(&init_net, ifindex);
+    if (dev && !__ethtool_get_link_ksettings(dev, &cmd) &&
+        cmd.base.speed != SPEED_UNKNOWN && cmd.base.speed != 0)
+        speed = cmd.base.speed;
+    rtnl_unlock();
+    return speed;
+}
+
+static struct net_iface *net_find_or_add(int ifindex, const char *name, bool *added)
+{
+    struct net_iface *iface;
+    int i;
+
+    *added = false;
+    for (i = 0; i < net_iface_count; i++) {
+        if (net_ifaces[i].ifindex == ifindex)
+            return &net_ifaces[i];
+    }
+    if (net_iface_count >= NET_MAX_DEVICES)
+        return NULL;
+
+    iface = &net_ifaces[net_iface_count++];
+    memset(iface, 0, sizeof(*iface));
+    iface->ifindex = ifindex;
+    strscpy(iface->name, name, sizeof(iface->name));
+    *added = true;
+    return iface;
+}
+
+static void net_source_sample(ktime_t now)
+{
+    struct rtnl_link_stats64 stats;
+    struct net_device *dev;
+    s64 elapsed_ms = ktime_ms_delta(now, net_last_sample);
+    unsigned long busiest = 0;
+    int i, j;
+
+    for (i = 0; i < net_iface_count; i++)
+        net_ifaces[i].seen = false;
+
+    rcu_read_lock();
+    for_each_netdev_rcu(&init_net, dev) {
+        struct net_iface *iface;
+        u64 drops, errors;
+        bool added;
+
+        iface = net_find_or_add(dev->ifindex, dev->name, &added);
+        if (!iface)
+            continue;
+        iface->seen = true;
+        // Renames keep the ifindex
+        strscpy(iface->name, dev->name, sizeof(iface->name));
+
+        dev_get_stats(dev, &stats);
+        drops = stats.rx_dropped + stats.tx_dropped;
+        errors = stats.rx_errors + stats.tx_errors;
+
+        if (iface->primed && elapsed_ms > 0) {
+            iface->rx_pps = div64_u64((stats.rx_packets - iface->rx_packets) * MSEC_PER_SEC, elapsed_ms);
+            iface->tx_pps = div64_u64((stats.tx_packets - iface->tx_packets) * MSEC_PER_SEC, elapsed_ms);
+            iface->rx_bps = div64_u64((stats.rx_bytes - iface->rx_bytes) * MSEC_PER_SEC, elapsed_ms);
+            iface->tx_bps = div64_u64((stats.tx_bytes - iface->tx_bytes) * MSEC_PER_SEC, elapsed_ms);
+            iface->drops_ps = div64_u64((drops - iface->drops) * MSEC_PER_SEC, elapsed_ms);
+            iface->errors_ps = div64_u64((errors - iface->errors) * MSEC_PER_SEC, elapsed_ms);
+        }
+
+        iface->rx_packets = stats.rx_packets;
+        iface->tx_packets = stats.tx_packets;
+        iface->rx_bytes = stats.rx_bytes;
+        iface->tx_bytes = stats.tx_bytes;
+        iface->drops = drops;
+        iface->errors = errors;
+        // Speed is filled in below, outside RCU, for newly seen interfaces
+        iface->primed = !added;
+    }
+    rcu_read_unlock();
+
+    // Drop interfaces that went away, fill in link speed for new ones and find the busiest link
+    for (i = 0, j = 0; i < net_iface_count; i++) {
+        struct net_iface *iface = &net_ifaces[i];
+
+        if (!iface->seen)
+            continue;
+        if (!iface->primed) {
+            iface->speed_mbps = net_link_speed(iface->ifindex);
+            iface->primed = true;
+        }
+        if (iface->speed_mbps) {
+            // bytes/s * 8 / (Mbit/s * 10^6) as a percentage
+            iface->util = min_t(u64, div64_u64((u64)max(iface->rx_bps, iface->tx_bps) * 8 * 100,
+                                               (u64)iface->speed_mbps * 1000000), 100);
+            busiest = max(busiest, iface->util);
+        }
+        if (i != j)
+            net_ifaces[j] = *iface;
+        j++;
+    }
+    net_iface_count = j;
+
+    net_last_sample = now;
+    monitor_state.net_utilization = busiest;
+}
+
+static int net_source_summary(char *buf, size_t size)
+{
+    unsigned long rx_pps = 0, tx_pps = 0, rx_bps = 0, tx_bps = 0, drops_ps = 0, errors_ps = 0;
+    int i;
+
+    for (i = 0; i < net_iface_count; i++) {
+        rx_pps += net_ifaces[i].rx_pps;
+        tx_pps += net_ifaces[i].tx_pps;
+        rx_bps += net_ifaces[i].rx_bps;
+        tx_bps += net_ifaces[i].tx_bps;
+        drops_ps += net_ifaces[i].drops_ps;
+        errors_ps += net_ifaces[i].errors_ps;
+    }
+
+    return scnprintf(buf, size, "Net: RX %lu pkt/s %lu KiB/s, TX %lu pkt/s %lu KiB/s, Drops %lu/s, Errors %lu/s, Busiest Link %lu%%\n",
+                     rx_pps, rx_bps / 1024, tx_pps, tx_bps / 1024, drops_ps, errors_ps, monitor_state.net_utilization);
+}
+
+static void net_source_exit(void)
+{
+    net_iface_count = 0;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/net/
+static ssize_t net_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "iface rx_pps tx_pps rx_bps tx_bps drops_ps errors_ps speed_mbps util%%\n");
+    for (i = 0; i < net_iface_count; i++) {
+        struct net_iface *iface = &net_ifaces[i];
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %lu %lu %lu %lu %lu %lu %u %lu\n",
+                         iface->name, iface->rx_pps, iface->tx_pps, iface->rx_bps, iface->tx_bps,
+                         iface->drops_ps, iface->errors_ps, iface->speed_mbps, iface->util);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t net_utilization_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long util;
+    mutex_lock(&monitor_config_mutex);
+    util = monitor_state.net_utilization;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", util);
+}
+
+static struct kobj_attribute net_stats_attribute = __ATTR(stats, 0444, net_stats_show, NULL);                       // Read-only
+static struct kobj_attribute net_utilization_attribute = __ATTR(utilization, 0444, net_utilization_show, NULL);     // Read-only
+
+static struct attribute *net_attrs[] = {
+    &net_stats_attribute.attr,
+    &net_utilization_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group net_attr_group = {
+    .name = "net",
+    .attrs = net_attrs,
+};
+
+static struct monitor_source net_source = {
+    .name = "net",
+    .exit = net_source_exit,
+    .sample = net_source_sample,
+    .summary = net_source_summary,
+    .attr_group = &net_attr_group,
+};
+
+// IRQ / Softirq Source
+// Derives per-CPU interrupt and softirq rates and their share of CPU time from the kernel's kstat/cpustat accounting.
+#define IRQ_STORM_PCT 50            // Hardirq+softirq share of a single CPU that counts as an interrupt storm
+
+struct irq_cpu_stats {
+    // Raw counters from the last sample
+    u64 irqs;
+    u64 softirqs[NR_SOFTIRQS];
+    u64 irq_ns, softirq_ns;
+    // Derived over the last interval
+    unsigned long irqs_ps;
+    unsigned long softirqs_ps;
+    unsigned long irq_pct, softirq_pct;     // 0-100 (% of interval)
+};
+
+// Softirq names in NR_SOFTIRQS order (softirq_to_name is not exported to modules)
+static const char * const irq_softirq_names[NR_SOFTIRQS] = {
+    "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU",
+};
+
+static struct irq_cpu_stats *irq_cpus;              // nr_cpu_ids entries
+static unsigned long irq_softirq_type_ps[NR_SOFTIRQS];  // Per-type rate summed across CPUs
+static bool irq_primed;
+static bool irq_storm_active;
+static unsigned long irq_storm_count;
+static ktime_t irq_last_sample;
+
+static void irq_source_sample(ktime_t now)
+{
+    struct kernel_cpustat kcs;
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, irq_last_sample));
+    unsigned long busiest = 0;
+    int cpu, nr;
+
+    memset(irq_softirq_type_ps, 0, sizeof(irq_softirq_type_ps));
+
+    for_each_possible_cpu(cpu) {
+        struct irq_cpu_stats *stats = &irq_cpus[cpu];
+        u64 irqs = kstat_cpu_irqs_sum(cpu);
+        u64 softirqs = 0, prev_softirqs = 0;
+
+        kcpustat_cpu_fetch(&kcs, cpu);
+
+        for (nr = 0; nr < NR_SOFTIRQS; nr++) {
+            u64 count = kstat_softirqs_cpu(nr, cpu);
+
+            if (irq_primed && elapsed_ns > 0)
+                irq_softirq_type_ps[nr] += div64_u64((count - stats->softirqs[nr]) * NSEC_PER_SEC, elapsed_ns);
+            softirqs += count;
+            prev_softirqs += stats->softirqs[nr];
+            stats->softirqs[nr] = count;
+        }
+
+        if (irq_primed && elapsed_ns > 0) {
+            stats->irqs_ps = div64_u64((irqs - stats->irqs) * NSEC_PER_SEC, elapsed_ns);
+            stats->softirqs_ps = div64_u64((softirqs - prev_softirqs) * NSEC_PER_SEC, elapsed_ns);
+            stats->irq_pct = min_t(u64, div64_u64((kcs.cpustat[CPUTIME_IRQ] - stats->irq_ns) * 100, elapsed_ns), 100);
+            stats->softirq_pct = min_t(u64, div64_u64((kcs.cpustat[CPUTIME_SOFTIRQ] - stats->softirq_ns) * 100, elapsed_ns), 100);
+            busiest = max(busiest, min(stats->irq_pct + stats->softirq_pct, 100UL));
+        }
+
+        stats->irqs = irqs;
+        stats->irq_ns = kcs.cpustat[CPUTIME_IRQ];
+        stats->softirq_ns = kcs.cpustat[CPUTIME_SOFTIRQ];
+    }
+
+    irq_primed = true;
+    irq_last_sample = now;
+    monitor_state.irq_load = busiest;
+
+    // Edge-triggered so a sustained storm raises a single alert
+    if (busiest >= IRQ_STORM_PCT && !irq_storm_active) {
+        irq_storm_active = true;
+        irq_storm_count++;
+        monitor_raise_alert("Interrupt Storm", busiest);
+        printk(KERN_WARNING "%s: Critical Alert: Interrupt Storm (%lu%% of a CPU in hardirq/softirq)!\n", DEVICE_NAME, busiest);
+    } else if (busiest < IRQ_STORM_PCT) {
+        irq_storm_active = false;
+    }
+}
+
+static int irq_source_summary(char *buf, size_t size)
+{
+    unsigned long irqs_ps = 0, softirqs_ps = 0;
+    int cpu;
+
+    for_each_possible_cpu(cpu) {
+        irqs_ps += irq_cpus[cpu].irqs_ps;
+        softirqs_ps += irq_cpus[cpu].softirqs_ps;
+    }
+
+    return scnprintf(buf, size, "IRQ: %lu irq/s, %lu softirq/s, Busiest CPU %lu%% in IRQ context, Storms %lu\n",
+                     irqs_ps, softirqs_ps, monitor_state.irq_load, irq_storm_count);
+}
+
+static int irq_source_init(void)
+{
+    irq_cpus = kcalloc(nr_cpu_ids, sizeof(*irq_cpus), GFP_KERNEL);
+    if (!irq_cpus)
+        return -ENOMEM;
+    return 0;
+}
+
+static void irq_source_exit(void)
+{
+    kfree(irq_cpus);
+    irq_cpus = NULL;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/irq/
+static ssize_t irq_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int cpu;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "cpu irqs_ps softirqs_ps irq%% softirq%%\n");
+    for_each_online_cpu(cpu) {
+        struct irq_cpu_stats *stats = &irq_cpus[cpu];
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d %lu %lu %lu %lu\n",
+                         cpu, stats->irqs_ps, stats->softirqs_ps, stats->irq_pct, stats->softirq_pct);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t irq_softirqs_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int nr;
+
+    mutex_lock(&monitor_config_mutex);
+    for (nr = 0; nr < NR_SOFTIRQS; nr++)
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %lu\n", irq_softirq_names[nr], irq_softirq_type_ps[nr]);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t irq_load_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long load;
+    mutex_lock(&monitor_config_mutex);
+    load = monitor_state.irq_load;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", load);
+}
+
+static ssize_t irq_storms_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long storms;
+    mutex_lock(&monitor_config_mutex);
+    storms = irq_storm_count;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", storms);
+}
+
+static struct kobj_attribute irq_stats_attribute = __ATTR(stats, 0444, irq_stats_show, NULL);               // Read-only
+static struct kobj_attribute irq_softirqs_attribute = __ATTR(softirqs, 0444, irq_softirqs_show, NULL);      // Read-only
+static struct kobj_attribute irq_load_attribute = __ATTR(load, 0444, irq_load_show, NULL);                  // Read-only
+static struct kobj_attribute irq_storms_attribute = __ATTR(storms, 0444, irq_storms_show, NULL);            // Read-only
+
+static struct attribute *irq_attrs[] = {
+    &irq_stats_attribute.attr,
+    &irq_softirqs_attribute.attr,
+    &irq_load_attribute.attr,
+    &irq_storms_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group irq_attr_group = {
+    .name = "irq",
+    .attrs = irq_attrs,
+};
+
+static struct monitor_source irq_source = {
+    .name = "irq",
+    .init = irq_source_init,
+    .exit = irq_source_exit,
+    .sample = irq_source_sample,
+    .summary = irq_source_summary,
+    .attr_group = &irq_attr_group,
+};
+
+// Steal Time Source
+// Derives per-CPU steal time (time the hypervisor ran something else while this guest CPU was runnable)
+// from kernel cpustat accounting, alongside guest-internal busy time so the two can be told apart.
+#define STEAL_CONTENTION_PCT 10     // Average steal at which the host, not the guest, is treated as the bottleneck
+
+struct steal_cpu_stats {
+    // Raw counters from the last sample
+    u64 steal_ns;
+    u64 busy_ns;
+    // Derived over the last interval
+    unsigned long steal_pct;    // 0-100 (% of interval)
+    unsigned long busy_pct;     // 0-100 (% of interval running guest work)
+};
+
+static struct steal_cpu_stats *steal_cpus;          // nr_cpu_ids entries
+static bool steal_primed;
+static unsigned long steal_busy_pct;                // Guest-internal busy time, averaged over online CPUs
+static unsigned long steal_suppressed;              // Scale-ups skipped because of host contention
+static ktime_t steal_last_sample;
+
+static void steal_source_sample(ktime_t now)
+{
+    struct kernel_cpustat kcs;
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, steal_last_sample));
+    unsigned long steal_sum = 0, busy_sum = 0;
+    int cpu, cpus = 0;
+
+    for_each_online_cpu(cpu) {
+        struct steal_cpu_stats *stats = &steal_cpus[cpu];
+        u64 steal, busy;
+
+        kcpustat_cpu_fetch(&kcs, cpu);
+        steal = kcs.cpustat[CPUTIME_STEAL];
+        busy = kcs.cpustat[CPUTIME_USER] + kcs.cpustat[CPUTIME_NICE] + kcs.cpustat[CPUTIME_SYSTEM] +
+               kcs.cpustat[CPUTIME_IRQ] + kcs.cpustat[CPUTIME_SOFTIRQ];
+
+        if (steal_primed && elapsed_ns > 0) {
+            stats->steal_pct = min_t(u64, div64_u64((steal - stats->steal_ns) * 100, elapsed_ns), 100);
+            stats->busy_pct = min_t(u64, div64_u64((busy - stats->busy_ns) * 100, elapsed_ns), 100);
+        }
+        stats->steal_ns = steal;
+        stats->busy_ns = busy;
+
+        steal_sum += stats->steal_pct;
+        busy_sum += stats->busy_pct;
+        cpus++;
+    }
+
+    steal_primed = true;
+    steal_last_sample = now;
+    monitor_state.steal_time = cpus ? steal_sum / cpus : 0;
+    steal_busy_pct = cpus ? busy_sum / cpus : 0;
+}
+
+static int steal_source_summary(char *buf, size_t size)
+{
+    return scnprintf(buf, size, "Steal: %lu%% (guest busy %lu%%), Scale-Ups Suppressed %lu\n",
+                     monitor_state.steal_time, steal_busy_pct, steal_suppressed);
+}
+
+static int steal_source_init(void)
+{
+    steal_cpus = kcalloc(nr_cpu_ids, sizeof(*steal_cpus), GFP_KERNEL);
+    if (!steal_cpus)
+        return -ENOMEM;
+    return 0;
+}
+
+static void steal_source_exit(void)
+{
+    kfree(steal_cpus);
+    steal_cpus = NULL;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/steal/
+static ssize_t steal_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int cpu;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "cpu steal%% busy%%\n");
+    for_each_online_cpu(cpu)
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d %lu %lu\n",
+                         cpu, steal_cpus[cpu].steal_pct, steal_cpus[cpu].busy_pct);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t steal_time_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long steal;
+    mutex_lock(&monitor_config_mutex);
+    steal = monitor_state.steal_time;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", steal);
+}
+
+static ssize_t steal_suppressed_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long suppressed;
+    mutex_lock(&monitor_config_mutex);
+    suppressed = steal_suppressed;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", suppressed);
+}
+
+static struct kobj_attribute steal_stats_attribute = __ATTR(stats, 0444, steal_stats_show, NULL);                   // Read-only
+static struct kobj_attribute steal_time_attribute = __ATTR(steal_time, 0444, steal_time_show, NULL);                // Read-only
+static struct kobj_attribute steal_suppressed_attribute = __ATTR(suppressed, 0444, steal_suppressed_show, NULL);    // Read-only
+
+static struct attribute *steal_attrs[] = {
+    &steal_stats_attribute.attr,
+    &steal_time_attribute.attr,
+    &steal_suppressed_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group steal_attr_group = {
+    .name = "steal",
+    .attrs = steal_attrs,
+};
+
+static struct monitor_source steal_source = {
+    .name = "steal",
+    .init = steal_source_init,
+    .exit = steal_source_exit,
+    .sample = steal_source_sample,
+    .summary = steal_source_summary,
+    .attr_group = &steal_attr_group,
+};
+
+// Memory Fragmentation / Reclaim Source
+// Samples per-zone buddy free lists and watermarks plus direct-reclaim and compaction event rates
+// from the vm event counters.
+#define MEM_MAX_ZONES 32
+// Order of the smallest huge page this kernel hands out (2 MiB with 4 KiB base pages, 32 MiB with 16 KiB, ...)
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+#define MEM_HUGE_ORDER HPAGE_PMD_ORDER
+#else
+#define MEM_HUGE_ORDER pageblock_order
+#endif
+#define MEM_STALL_FULL_PS 100       // Direct reclaim + compaction stalls per second that count as 100% pressure
+#define MEM_ALERT_SUSTAIN_MS 1000   // Pressure must stay at 100% this long before alerting
+
+struct mem_zone_stats {
+    int node;
+    const char *name;
+    unsigned long free_pages;
+    unsigned long nr_free[NR_PAGE_ORDERS];
+    unsigned long min_wmark, low_wmark, high_wmark;
+    long wmark_distance;        // Free pages above the low watermark (negative = kswapd territory)
+    unsigned long pressure;     // 0-100 (0 at/above high watermark, 100 at/below min watermark)
+};
+
+// vm events tracked as rates
+enum mem_event {
+    MEM_EVENT_ALLOCSTALL,       // Allocations that entered direct reclaim
+    MEM_EVENT_PGSCAN_DIRECT,    // Pages scanned by direct reclaim
+    MEM_EVENT_PGSTEAL_DIRECT,   // Pages reclaimed by direct reclaim
+    MEM_EVENT_COMPACTSTALL,     // Allocations that entered direct compaction
+    MEM_EVENT_COMPACTFAIL,      // Direct compactions that failed
+    NR_MEM_EVENTS,
+};
+
+static const char * const mem_event_names[NR_MEM_EVENTS] = {
+    "allocstall", "pgscan_direct", "pgsteal_direct", "compact_stall", "compact_fail",
+};
+
+static struct mem_zone_stats mem_zones[MEM_MAX_ZONES];
+static int mem_zone_count;
+static unsigned long *mem_vm_events;                // NR_VM_EVENT_ITEMS scratch buffer for all_vm_events()
+static unsigned long mem_event_prev[NR_MEM_EVENTS];
+static unsigned long mem_event_ps[NR_MEM_EVENTS];
+static bool mem_primed;
+static bool mem_alert_active;
+static ktime_t mem_full_since;                      // When pressure last reached 100%, 0 while below
+static ktime_t mem_last_sample;
+
+static void mem_sample_zones(void)
+{
+    int nid, z, order;
+
+    mem_zone_count = 0;
+    for_each_online_node(nid) {
+        pg_data_t *pgdat = NODE_DATA(nid);
+
+        for (z = 0; z < MAX_NR_ZONES && mem_zone_count < MEM_MAX_ZONES; z++) {
+            struct zone *zone = &pgdat->node_zones[z];
+            struct mem_zone_stats *stats;
+            unsigned long span;
+
+            if (!populated_zone(zone))
+                continue;
+
+            stats = &mem_zones[mem_zone_count++];
+            stats->node = nid;
+            stats->name = zone->name;
+            stats->free_pages = zone_page_state(zone, NR_FREE_PAGES);
+            // Read without zone->lock, a slightly stale count is fine for monitoring
+            for (order = 0; order < NR_PAGE_ORDERS; order++)
+                stats->nr_free[order] = READ_ONCE(zone->free_area[order].nr_free);
+            stats->min_wmark = min_wmark_pages(zone);
+            stats->low_wmark = low_wmark_pages(zone);
+            stats->high_wmark = high_wmark_pages(zone);
+            stats->wmark_distance = (long)stats->free_pages - (long)stats->low_wmark;
+
+            span = stats->high_wmark > stats->min_wmark ? stats->high_wmark - stats->min_wmark : 1;
+            if (stats->free_pages >= stats->high_wmark)
+                stats->pressure = 0;
+            else if (stats->free_pages <= stats->min_wmark)
+                stats->pressure = 100;
+            else
+                stats->pressure = (stats->high_wmark - stats->free_pages) * 100 / span;
+        }
+    }
+}
+
+static void mem_sample_events(s64 elapsed_ms)
+{
+    unsigned long now_events[NR_MEM_EVENTS] = { 0 };
+    int i;
+
+    all_vm_events(mem_vm_events);
+    // ALLOCSTALL is counted per zone type
+    for (i = 0; i < MAX_NR_ZONES; i++)
+        now_events[MEM_EVENT_ALLOCSTALL] += mem_vm_events[ALLOCSTALL_NORMAL - ZONE_NORMAL + i];
+    now_events[MEM_EVENT_PGSCAN_DIRECT] = mem_vm_events[PGSCAN_DIRECT];
+    now_events[MEM_EVENT_PGSTEAL_DIRECT] = mem_vm_events[PGSTEAL_DIRECT];
+#ifdef CONFIG_COMPACTION
+    now_events[MEM_EVENT_COMPACTSTALL] = mem_vm_events[COMPACTSTALL];
+    now_events[MEM_EVENT_COMPACTFAIL] = mem_vm_events[COMPACTFAIL];
+#endif
+
+    for (i = 0; i < NR_MEM_EVENTS; i++) {
+        if (mem_primed && elapsed_ms > 0)
+            mem_event_ps[i] = div64_u64((u64)(now_events[i] - mem_event_prev[i]) * MSEC_PER_SEC, elapsed_ms);
+        mem_event_prev[i] = now_events[i];
+    }
+}
+
+static void mem_source_sample(ktime_t now)
+{
+    unsigned long pressure = 0, stalls_ps;
+    int i;
+
+    mem_sample_zones();
+    mem_sample_events(ktime_ms_delta(now, mem_last_sample));
+    mem_primed = true;
+    mem_last_sample = now;
+
+    for (i = 0; i < mem_zone_count; i++)
+        pressure = max(pressure, mem_zones[i].pressure);
+
+    // Allocations stalling in direct reclaim/compaction means latency is being paid right now. Scale by the
+    // stall rate, an occasional stall on a busy host is not pressure.
+    stalls_ps = mem_event_ps[MEM_EVENT_ALLOCSTALL] + mem_event_ps[MEM_EVENT_COMPACTSTALL];
+    pressure = max(pressure, min(stalls_ps * 100 / MEM_STALL_FULL_PS, 100UL));
+    monitor_state.reclaim_pressure = pressure;
+
+    // Edge-triggered, and only once full pressure has been sustained, so a burst raises nothing and
+    // sustained reclaim raises a single alert
+    if (pressure < 100) {
+        mem_full_since = 0;
+        mem_alert_active = false;
+    } else if (!mem_full_since) {
+        mem_full_since = now;
+    } else if (!mem_alert_active && ktime_ms_delta(now, mem_full_since) >= MEM_ALERT_SUSTAIN_MS) {
+        mem_alert_active = true;
+        monitor_raise_alert("Memory Reclaim Pressure", pressure);
+        printk(KERN_WARNING "%s: Critical Alert: Memory Reclaim Pressure (allocstall %lu/s, compact_stall %lu/s)!\n",
+               DEVICE_NAME, mem_event_ps[MEM_EVENT_ALLOCSTALL], mem_event_ps[MEM_EVENT_COMPACTSTALL]);
+    }
+}
+
+static int mem_source_summary(char *buf, size_t size)
+{
+    unsigned long free_pages = 0, huge_free = 0;
+    int i, order;
+
+    for (i = 0; i < mem_zone_count; i++) {
+        free_pages += mem_zones[i].free_pages;
+        for (order = MEM_HUGE_ORDER; order < NR_PAGE_ORDERS; order++)
+            huge_free += mem_zones[i].nr_free[order] << order;
+    }
+
+    return scnprintf(buf, size, "Memory: %lu MiB free (%lu%% in huge-page blocks), Reclaim Pressure %lu%%, Direct Reclaim %lu/s, Compaction Stalls %lu/s\n",
+                     free_pages >> (20 - PAGE_SHIFT), free_pages ? huge_free * 100 / free_pages : 0,
+                     monitor_state.reclaim_pressure, mem_event_ps[MEM_EVENT_ALLOCSTALL], mem_event_ps[MEM_EVENT_COMPACTSTALL]);
+}
+
+static int mem_source_init(void)
+{
+    mem_vm_events = kcalloc(NR_VM_EVENT_ITEMS, sizeof(*mem_vm_events), GFP_KERNEL);
+    if (!mem_vm_events)
+        return -ENOMEM;
+    return 0;
+}
+
+static void mem_source_exit(void)
+{
+    kfree(mem_vm_events);
+    mem_vm_events = NULL;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/memory/
+static ssize_t mem_zones_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i, order;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "node zone free min low high wmark_distance pressure%% free_per_order...\n");
+    for (i = 0; i < mem_zone_count; i++) {
+        struct mem_zone_stats *stats = &mem_zones[i];
+
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d %s %lu %lu %lu %lu %ld %lu",
+                         stats->node, stats->name, stats->free_pages, stats->min_wmark, stats->low_wmark,
+                         stats->high_wmark, stats->wmark_distance, stats->pressure);
+        for (order = 0; order < NR_PAGE_ORDERS; order++)
+            len += scnprintf(buf + len, PAGE_SIZE - len, " %lu", stats->nr_free[order]);
+        len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t mem_events_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < NR_MEM_EVENTS; i++)
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %lu\n", mem_event_names[i], mem_event_ps[i]);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t mem_reclaim_pressure_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long pressure;
+    mutex_lock(&monitor_config_mutex);
+    pressure = monitor_state.reclaim_pressure;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", pressure);
+}
+
+static struct kobj_attribute mem_zones_attribute = __ATTR(zones, 0444, mem_zones_show, NULL);                                       // Read-only
+static struct kobj_attribute mem_events_attribute = __ATTR(events, 0444, mem_events_show, NULL);                                    // Read-only
+static struct kobj_attribute mem_reclaim_pressure_attribute = __ATTR(reclaim_pressure, 0444, mem_reclaim_pressure_show, NULL);      // Read-only
+
+static struct attribute *mem_attrs[] = {
+    &mem_zones_attribute.attr,
+    &mem_events_attribute.attr,
+    &mem_reclaim_pressure_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group mem_attr_group = {
+    .name = "memory",
+    .attrs = mem_attrs,
+};
+
+static struct monitor_source mem_source = {
+    .name = "memory",
+    .init = mem_source_init,
+    .exit = mem_source_exit,
+    .sample = mem_source_sample,
+    .summary = mem_source_summary,
+    .attr_group = &mem_attr_group,
+};
+
+// Perf Counter Source
+// Per-CPU in-kernel perf counters read each sample. Software counters are always available, hardware
+// counters are used when the PMU can provide them (bare metal, most VMs without PMU passthrough fall back).
+// CPU hotplug callbacks create a CPU's counters when it comes online and release them when it goes down.
+enum perf_counter_id {
+    PERF_CTR_CONTEXT_SWITCHES,
+    PERF_CTR_CPU_MIGRATIONS,
+    PERF_CTR_PAGE_FAULTS,
+    PERF_CTR_MAJOR_FAULTS,
+    NR_PERF_SW_COUNTERS,
+    PERF_CTR_INSTRUCTIONS = NR_PERF_SW_COUNTERS,
+    PERF_CTR_CYCLES,
+    PERF_CTR_CACHE_MISSES,
+    NR_PERF_COUNTERS,
+};
+
+struct perf_counter_def {
+    const char *name;
+    u32 type;
+    u64 config;
+};
+
+static const struct perf_counter_def perf_counter_defs[NR_PERF_COUNTERS] = {
+    [PERF_CTR_CONTEXT_SWITCHES] = { "context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    [PERF_CTR_CPU_MIGRATIONS]   = { "cpu_migrations",   PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+    [PERF_CTR_PAGE_FAULTS]      = { "page_faults",      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    [PERF_CTR_MAJOR_FAULTS]     = { "major_faults",     PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ },
+    [PERF_CTR_INSTRUCTIONS]     = { "instructions",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [PERF_CTR_CYCLES]           = { "cycles",           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [PERF_CTR_CACHE_MISSES]     = { "cache_misses",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+};
+
+struct perf_cpu_counters {
+    struct perf_event *events[NR_PERF_COUNTERS];
+    u64 last[NR_PERF_COUNTERS];
+    unsigned long rate[NR_PERF_COUNTERS];       // Events per second over the last interval
+};
+
+static struct perf_cpu_counters *perf_cpus;         // nr_cpu_ids entries
+static int perf_nr_counters;                        // NR_PERF_SW_COUNTERS, or NR_PERF_COUNTERS when the PMU is usable
+static unsigned long perf_totals[NR_PERF_COUNTERS]; // Rates summed across CPUs
+static unsigned long perf_ipc;                      // Instructions per cycle x100, 0 without hardware counters
+static bool perf_primed;
+static ktime_t perf_last_sample;
+static int perf_cpuhp_state;                        // Dynamic hotplug state, 0 when not registered
+static DEFINE_MUTEX(perf_cpus_mutex);               // Serializes hotplug callbacks against sampling
+
+static struct perf_event *perf_create_counter(int id, int cpu)
+{
+    struct perf_event_attr attr = {
+        .type = perf_counter_defs[id].type,
+        .config = perf_counter_defs[id].config,
+        .size = sizeof(struct perf_event_attr),
+        .pinned = perf_counter_defs[id].type == PERF_TYPE_SOFTWARE,
+        .disabled = 0,
+    };
+
+    return perf_event_create_kernel_counter(&attr, cpu, NULL, NULL, NULL);
+}
+
+static void perf_release_counters(int first, int last)
+{
+    int cpu, id;
+
+    for_each_possible_cpu(cpu) {
+        for (id = first; id < last; id++) {
+            if (perf_cpus[cpu].events[id]) {
+                perf_event_release_kernel(perf_cpus[cpu].events[id]);
+                perf_cpus[cpu].events[id] = NULL;
+            }
+        }
+    }
+}
+
+static int perf_cpu_online(unsigned int cpu)
+{
+    struct perf_event *event;
+    int id;
+
+    // Never fail the hotplug operation, a CPU without counters just reports zero rates
+    mutex_lock(&perf_cpus_mutex);
+    for (id = 0; id < perf_nr_counters; id++) {
+        event = perf_create_counter(id, cpu);
+        if (IS_ERR(event)) {
+            printk(KERN_WARNING "%s: Failed to create perf %s counter on CPU %u (%ld)\n",
+                   DEVICE_NAME, perf_counter_defs[id].name, cpu, PTR_ERR(event));
+            continue;
+        }
+        perf_cpus[cpu].events[id] = event;
+        perf_cpus[cpu].last[id] = 0;
+        perf_cpus[cpu].rate[id] = 0;
+    }
+    mutex_unlock(&perf_cpus_mutex);
+    return 0;
+}
+
+static int perf_cpu_offline(unsigned int cpu)
+{
+    int id;
+
+    mutex_lock(&perf_cpus_mutex);
+    for (id = 0; id < NR_PERF_COUNTERS; id++) {
+        if (perf_cpus[cpu].events[id]) {
+            perf_event_release_kernel(perf_cpus[cpu].events[id]);
+            perf_cpus[cpu].events[id] = NULL;
+        }
+        perf_cpus[cpu].rate[id] = 0;
+    }
+    mutex_unlock(&perf_cpus_mutex);
+    return 0;
+}
+
+static int perf_source_init(void)
+{
+    struct perf_event *event;
+    int cpu, id, ret;
+
+    perf_cpus = kcalloc(nr_cpu_ids, sizeof(*perf_cpus), GFP_KERNEL);
+    if (!perf_cpus)
+        return -ENOMEM;
+
+    // Hold off hotplug until the callbacks are registered, so no CPU is missed or counted twice
+    cpus_read_lock();
+    perf_nr_counters = NR_PERF_COUNTERS;
+    for_each_online_cpu(cpu) {
+        for (id = 0; id < perf_nr_counters; id++) {
+            event = perf_create_counter(id, cpu);
+            if (!IS_ERR(event)) {
+                perf_cpus[cpu].events[id] = event;
+                continue;
+            }
+
+            if (id < NR_PERF_SW_COUNTERS) {
+                printk(KERN_ALERT "%s: Failed to create perf %s counter on CPU %d (%ld)\n",
+                       DEVICE_NAME, perf_counter_defs[id].name, cpu, PTR_ERR(event));
+                perf_release_counters(0, NR_PERF_COUNTERS);
+                cpus_read_unlock();
+                kfree(perf_cpus);
+                perf_cpus = NULL;
+                return PTR_ERR(event);
+            }
+
+            // No usable PMU (typical in VMs), drop hardware counters everywhere and keep going
+            printk(KERN_INFO "%s: Hardware perf counters unavailable (%ld), using software counters only\n",
+                   DEVICE_NAME, PTR_ERR(event));
+            perf_release_counters(NR_PERF_SW_COUNTERS, NR_PERF_COUNTERS);
+            perf_nr_counters = NR_PERF_SW_COUNTERS;
+            break;
+        }
+    }
+
+    ret = cpuhp_setup_state_nocalls_cpuslocked(CPUHP_AP_ONLINE_DYN, "auto_monitor/perf:online",
+                                               perf_cpu_online, perf_cpu_offline);
+    cpus_read_unlock();
+    if (ret < 0) {
+        // Keep the counters of the CPUs online now, hotplugged CPUs just won't be counted
+        printk(KERN_WARNING "%s: Failed to register perf CPU hotplug callbacks (%d)\n", DEVICE_NAME, ret);
+        return 0;
+    }
+    perf_cpuhp_state = ret;
+    return 0;
+}
+
+static void perf_source_exit(void)
+{
+    if (!perf_cpus)
+        return;
+    if (perf_cpuhp_state > 0) {
+        cpuhp_remove_state_nocalls(perf_cpuhp_state);
+        perf_cpuhp_state = 0;
+    }
+    perf_release_counters(0, NR_PERF_COUNTERS);
+    kfree(perf_cpus);
+    perf_cpus = NULL;
+}
+
+static void perf_source_sample(ktime_t now)
+{
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, perf_last_sample));
+    u64 enabled, running, value;
+    int cpu, id;
+
+    memset(perf_totals, 0, sizeof(perf_totals));
+
+    mutex_lock(&perf_cpus_mutex);
+    for_each_possible_cpu(cpu) {
+        struct perf_cpu_counters *counters = &perf_cpus[cpu];
+
+        for (id = 0; id < perf_nr_counters; id++) {
+            if (!counters->events[id])
+                continue;
+
+            value = perf_event_read_value(counters->events[id], &enabled, &running);
+            // Scale up hardware counters that were multiplexed off the PMU for part of the time
+            if (running && running < enabled)
+                value = mul_u64_u64_div_u64(value, enabled, running);
+
+            if (perf_primed && elapsed_ns > 0 && value >= counters->last[id])
+                counters->rate[id] = div64_u64((value - counters->last[id]) * NSEC_PER_SEC, elapsed_ns);
+            counters->last[id] = value;
+            perf_totals[id] += counters->rate[id];
+        }
+    }
+    mutex_unlock(&perf_cpus_mutex);
+
+    perf_primed = true;
+    perf_last_sample = now;
+    perf_ipc = perf_nr_counters > PERF_CTR_CYCLES && perf_totals[PERF_CTR_CYCLES] ?
+               div64_u64((u64)perf_totals[PERF_CTR_INSTRUCTIONS] * 100, perf_totals[PERF_CTR_CYCLES]) : 0;
+}
+
+static int perf_source_summary(char *buf, size_t size)
+{
+    int len;
+
+    len = scnprintf(buf, size, "Perf: %lu ctx-switch/s, %lu migrations/s, %lu faults/s, %lu major-faults/s\n",
+                    perf_totals[PERF_CTR_CONTEXT_SWITCHES], perf_totals[PERF_CTR_CPU_MIGRATIONS],
+                    perf_totals[PERF_CTR_PAGE_FAULTS], perf_totals[PERF_CTR_MAJOR_FAULTS]);
+    if (perf_nr_counters == NR_PERF_COUNTERS)
+        len += scnprintf(buf + len, size - len, "Perf HW: IPC %lu.%02lu, %lu cache-misses/s\n",
+                         perf_ipc / 100, perf_ipc % 100, perf_totals[PERF_CTR_CACHE_MISSES]);
+    return len;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/perf/
+static ssize_t perf_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int cpu, id;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "cpu");
+    for (id = 0; id < perf_nr_counters; id++)
+        len += scnprintf(buf + len, PAGE_SIZE - len, " %s", perf_counter_defs[id].name);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+
+    for_each_online_cpu(cpu) {
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d", cpu);
+        for (id = 0; id < perf_nr_counters; id++)
+            len += scnprintf(buf + len, PAGE_SIZE - len, " %lu", perf_cpus[cpu].rate[id]);
+        len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t perf_hardware_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    return sprintf(buf, "%d\n", perf_nr_counters == NR_PERF_COUNTERS);
+}
+
+static struct kobj_attribute perf_stats_attribute = __ATTR(stats, 0444, perf_stats_show, NULL);             // Read-only
+static struct kobj_attribute perf_hardware_attribute = __ATTR(hardware, 0444, perf_hardware_show, NULL);    // Read-only
+
+static struct attribute *perf_attrs[] = {
+    &perf_stats_attribute.attr,
+    &perf_hardware_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group perf_attr_group = {
+    .name = "perf",
+    .attrs = perf_attrs,
+};
+
+static struct monitor_source perf_source = {
+    .name = "perf",
+    .init = perf_source_init,
+    .exit = perf_source_exit,
+    .sample = perf_source_sample,
+    .summary = perf_source_summary,
+    .attr_group = &perf_attr_group,
+};
+
+// Cgroup Source
+// Tracks CPU usage, memory usage and PSI for every cgroup v2 under a configurable root. Entries live in a
+// hash table keyed by cgroup id, updated in place each sample and pruned once their cgroup disappears.
+// Each cgroup also gets its own resource factor, stepped on its worst PSI "some" pressure.
+#define CGROUP_HASH_BITS 10
+#define CGROUP_MAX_TRACKED 4096
+#define CGROUP_ROOT_LEN 256
+#define CGROUP_SPARE_MIN 32         // Entries kept preallocated for cgroups that appear during the RCU walk
+
+struct cgroup_entry {
+    struct hlist_node node;
+    u64 id;
+    unsigned long generation;   // Sample generation this cgroup was last seen in
+    bool primed;
+    u64 cpu_usage_ns;
+    u64 memory_bytes;
+    unsigned long cpu_pct;
+    unsigned long psi_cpu_some, psi_memory_some, psi_io_some;  // avg10 x100
+    unsigned long resource_factor;
+    char path[AUTO_MONITOR_CGROUP_PATH_LEN];
+};
+
+static DEFINE_HASHTABLE(cgroup_table, CGROUP_HASH_BITS);
+static HLIST_HEAD(cgroup_spare);    // Zeroed entries allocated outside the walk
+static unsigned long cgroup_spare_count;
+static unsigned long cgroup_count;
+static unsigned long cgroup_generation;
+static struct cgroup *cgroup_root;
+static char cgroup_root_path[CGROUP_ROOT_LEN] = "/";
+static ktime_t cgroup_last_sample;
+
+static struct cgroup_entry *cgroup_lookup(u64 id)
+{
+    struct cgroup_entry *entry;
+
+    hash_for_each_possible(cgroup_table, entry, node, id) {
+        if (entry->id == id)
+            return entry;
+    }
+    return NULL;
+}
+
+static void cgroup_clear_table(void)
+{
+    struct cgroup_entry *entry;
+    struct hlist_node *tmp;
+    int bkt;
+
+    hash_for_each_safe(cgroup_table, bkt, tmp, entry, node) {
+        hash_del(&entry->node);
+        kfree(entry);
+    }
+    cgroup_count = 0;
+}
+
+// Top up the spare entries with sleeping allocations; wanted is how many new cgroups the last walk had
+// no entry for, so a burst of new cgroups is picked up on the next sample
+static void cgroup_refill_spare(unsigned long wanted)
+{
+    struct cgroup_entry *entry;
+    unsigned long target = min(max(wanted, (unsigned long)CGROUP_SPARE_MIN), CGROUP_MAX_TRACKED - cgroup_count);
+
+    while (cgroup_spare_count < target) {
+        entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+        if (!entry)
+            break;
+        hlist_add_head(&entry->node, &cgroup_spare);
+        cgroup_spare_count++;
+    }
+}
+
+static void cgroup_free_spare(void)
+{
+    struct cgroup_entry *entry;
+    struct hlist_node *tmp;
+
+    hlist_for_each_entry_safe(entry, tmp, &cgroup_spare, node) {
+        hlist_del(&entry->node);
+        kfree(entry);
+    }
+    cgroup_spare_count = 0;
+}
+
+// PSI averages are fixed point percentages (FSHIFT), convert to x100 integers
+static unsigned long cgroup_psi_avg10(struct psi_group *psi, int state)
+{
+    unsigned long avg = READ_ONCE(psi->avg[state][0]);
+    return LOAD_INT(avg) * 100 + LOAD_FRAC(avg);
+}
+
+static void cgroup_update_entry(struct cgroup_entry *entry, struct cgroup *cgrp, s64 elapsed_ns,
+                                const struct adjust_config *cfg)
+{
+    u64 cpu_usage = cgrp->bstat.cputime.sum_exec_runtime;
+    unsigned long pressure;
+#ifdef CONFIG_MEMCG
+    struct cgroup_subsys_state *css;
+#endif
+
+    if (entry->primed && elapsed_ns > 0 && cpu_usage >= entry->cpu_usage_ns)
+        entry->cpu_pct = div64_u64((cpu_usage - entry->cpu_usage_ns) * 100, elapsed_ns);
+    entry->cpu_usage_ns = cpu_usage;
+
+    entry->memory_bytes = 0;
+#ifdef CONFIG_MEMCG
+    css = rcu_dereference(cgrp->subsys[memory_cgrp_id]);
+    if (css)
+        entry->memory_bytes = (u64)page_counter_read(&mem_cgroup_from_css(css)->memory) << PAGE_SHIFT;
+#endif
+
+#ifdef CONFIG_PSI
+    if (cgrp->psi) {
+        entry->psi_cpu_some = cgroup_psi_avg10(cgrp->psi, PSI_CPU_SOME);
+        entry->psi_memory_some = cgroup_psi_avg10(cgrp->psi, PSI_MEM_SOME);
+        entry->psi_io_some = cgroup_psi_avg10(cgrp->psi, PSI_IO_SOME);
+    }
+#endif
+    entry->primed = true;
+
+    // Same step rules as the machine-wide factor, driven by the tenant's own worst stall pressure
+    pressure = max3(entry->psi_cpu_some, entry->psi_memory_some, entry->psi_io_some) / 100;
+    entry->resource_factor = min(entry->resource_factor, cfg->max_factor);
+    if (pressure > cfg->high_threshold && entry->resource_factor < cfg->max_factor)
+        entry->resource_factor++;
+    else if (pressure < cfg->low_threshold && entry->resource_factor > 1)
+        entry->resource_factor--;
+}
+
+static void cgroup_source_sample(ktime_t now)
+{
+    struct cgroup_subsys_state *pos;
+    struct cgroup_entry *entry;
+    struct hlist_node *tmp;
+    struct adjust_config cfg;
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, cgroup_last_sample));
+    unsigned long missing = 0;
+    int bkt;
+
+    if (!cgroup_root)
+        return;
+    adjust_config_get(&cfg);
+    cgroup_refill_spare(0);
+
+#ifdef AUTO_MONITOR_HAVE_RSTAT_FLUSH
+    // Propagate per-CPU cputime up the subtree before reading it (may sleep). Only kernels that export
+    // cgroup_rstat_flush() to modules allow this, see the Makefile.
+    cgroup_rstat_flush(cgroup_root);
+#endif
+
+    cgroup_generation++;
+    rcu_read_lock();
+    css_for_each_descendant_pre(pos, &cgroup_root->self) {
+        struct cgroup *cgrp = pos->cgroup;
+        u64 id = cgroup_id(cgrp);
+
+        // The top-level root keeps no per-cgroup stats, the machine-wide sources cover it
+        if (!cgroup_parent(cgrp))
+            continue;
+
+        entry = cgroup_lookup(id);
+        if (!entry) {
+            if (cgroup_count >= CGROUP_MAX_TRACKED)
+                continue;
+            // No allocating inside the RCU walk, take a spare or pick the cgroup up next sample
+            if (hlist_empty(&cgroup_spare)) {
+                missing++;
+                continue;
+            }
+            entry = hlist_entry(cgroup_spare.first, struct cgroup_entry, node);
+            hlist_del(&entry->node);
+            cgroup_spare_count--;
+            entry->id = id;
+            entry->resource_factor = cfg.initial_factor;
+            cgroup_path(cgrp, entry->path, sizeof(entry->path));
+            hash_add(cgroup_table, &entry->node, id);
+            cgroup_count++;
+        }
+        entry->generation = cgroup_generation;
+        cgroup_update_entry(entry, cgrp, elapsed_ns, &cfg);
+    }
+    rcu_read_unlock();
+
+    // Prune cgroups that were removed since the last sample
+    hash_for_each_safe(cgroup_table, bkt, tmp, entry, node) {
+        if (entry->generation != cgroup_generation) {
+            hash_del(&entry->node);
+            kfree(entry);
+            cgroup_count--;
+        }
+    }
+
+    cgroup_refill_spare(missing);
+    cgroup_last_sample = now;
+}
+
+static int cgroup_source_summary(char *buf, size_t size)
+{
+    return scnprintf(buf, size, "Cgroups: %lu tracked under %s\n", cgroup_count, cgroup_root_path);
+}
+
+static int cgroup_source_init(void)
+{
+    cgroup_root = cgroup_get_from_path(cgroup_root_path);
+    if (IS_ERR(cgroup_root)) {
+        // Not fatal, e.g. no cgroup v2 hierarchy mounted yet; a root can be set later through Sysfs
+        printk(KERN_INFO "%s: Cgroup root %s unavailable (%ld), cgroup tracking idle\n",
+               DEVICE_NAME, cgroup_root_path, PTR_ERR(cgroup_root));
+        cgroup_root = NULL;
+    }
+    return 0;
+}
+
+static void cgroup_source_exit(void)
+{
+    cgroup_clear_table();
+    cgroup_free_spare();
+    if (cgroup_root) {
+        cgroup_put(cgroup_root);
+        cgroup_root = NULL;
+    }
+}
+
+static void cgroup_fill_stat(struct auto_monitor_cgroup_stat *stat, const struct cgroup_entry *entry)
+{
+    memset(stat, 0, sizeof(*stat));
+    stat->id = entry->id;
+    stat->cpu_usage_ns = entry->cpu_usage_ns;
+    stat->memory_bytes = entry->memory_bytes;
+    stat->cpu_pct = entry->cpu_pct;
+    stat->psi_cpu_some = entry->psi_cpu_some;
+    stat->psi_memory_some = entry->psi_memory_some;
+    stat->psi_io_some = entry->psi_io_some;
+    stat->resource_factor = entry->resource_factor;
+    strscpy(stat->path, entry->path, sizeof(stat->path));
+}
+
+// ioctl: AUTO_MONITOR_IOC_CGROUP_LIST
+static long cgroup_ioctl_list(struct auto_monitor_cgroup_list __user *uarg)
+{
+    struct auto_monitor_cgroup_list list;
+    struct auto_monitor_cgroup_stat *stats;
+    struct cgroup_entry *entry;
+    u32 count = 0;
+    int bkt;
+    long ret = 0;
+
+    if (copy_from_user(&list, uarg, sizeof(list)))
+        return -EFAULT;
+    list.capacity = min_t(u32, list.capacity, CGROUP_MAX_TRACKED);
+
+    // Snapshot under the mutex, copy to user-space after dropping it
+    stats = kvcalloc(max_t(u32, list.capacity, 1), sizeof(*stats), GFP_KERNEL);
+    if (!stats)
+        return -ENOMEM;
+
+    mutex_lock(&monitor_config_mutex);
+    hash_for_each(cgroup_table, bkt, entry, node) {
+        if (count >= list.capacity)
+            break;
+        cgroup_fill_stat(&stats[count++], entry);
+    }
+    list.total = cgroup_count;
+    mutex_unlock(&monitor_config_mutex);
+
+    list.count = count;
+    if (count && copy_to_user(u64_to_user_ptr(list.entries), stats, count * sizeof(*stats)))
+        ret = -EFAULT;
+    else if (copy_to_user(uarg, &list, sizeof(list)))
+        ret = -EFAULT;
+
+    kvfree(stats);
+    return ret;
+}
+
+// ioctl: AUTO_MONITOR_IOC_CGROUP_GET
+static long cgroup_ioctl_get(struct auto_monitor_cgroup_stat __user *uarg)
+{
+    struct auto_monitor_cgroup_stat stat;
+    struct cgroup_entry *entry;
+    u64 id;
+
+    if (get_user(id, &uarg->id))
+        return -EFAULT;
+
+    mutex_lock(&monitor_config_mutex);
+    entry = cgroup_lookup(id);
+    if (entry)
+        cgroup_fill_stat(&stat, entry);
+    mutex_unlock(&monitor_config_mutex);
+
+    if (!entry)
+        return -ENOENT;
+    if (copy_to_user(uarg, &stat, sizeof(stat)))
+        return -EFAULT;
+    return 0;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/cgroup/
+static ssize_t cgroup_root_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len;
+    mutex_lock(&monitor_config_mutex);
+    len = sprintf(buf, "%s\n", cgroup_root_path);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t cgroup_root_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    char path[CGROUP_ROOT_LEN];
+    struct cgroup *cgrp;
+
+    if (count >= CGROUP_ROOT_LEN)
+        return -EINVAL;
+    strscpy(path, buf, sizeof(path));
+
+    // Path relative to the cgroup2 mount, e.g. "/" or "/system.slice"
+    cgrp = cgroup_get_from_path(strim(path));
+    if (IS_ERR(cgrp))
+        return PTR_ERR(cgrp);
+
+    mutex_lock(&monitor_config_mutex);
+    cgroup_clear_table();
+    if (cgroup_root)
+        cgroup_put(cgroup_root);
+    cgroup_root = cgrp;
+    strscpy(cgroup_root_path, strim(path), sizeof(cgroup_root_path));
+    mutex_unlock(&monitor_config_mutex);
+
+    printk(KERN_INFO "%s: Cgroup root set to %s\n", DEVICE_NAME, strim(path));
+    return count;
+}
+
+static ssize_t cgroup_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct cgroup_entry *entry;
+    ssize_t len = 0;
+    int bkt;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "id cpu%% memory_bytes psi_cpu psi_memory psi_io factor path\n");
+    // Sysfs is limited to a page, the ioctl interface returns the full table
+    hash_for_each(cgroup_table, bkt, entry, node) {
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%llu %lu %llu %lu.%02lu %lu.%02lu %lu.%02lu %lu %s\n",
+                         entry->id, entry->cpu_pct, entry->memory_bytes,
+                         entry->psi_cpu_some / 100, entry->psi_cpu_some % 100,
+                         entry->psi_memory_some / 100, entry->psi_memory_some % 100,
+                         entry->psi_io_some / 100, entry->psi_io_some % 100,
+                         entry->resource_factor, entry->path);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t cgroup_count_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long count;
+    mutex_lock(&monitor_config_mutex);
+    count = cgroup_count;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", count);
+}
+
+static struct kobj_attribute cgroup_root_attribute = __ATTR(root, 0664, cgroup_root_show, cgroup_root_store);   // Read/Write
+static struct kobj_attribute cgroup_stats_attribute = __ATTR(stats, 0444, cgroup_stats_show, NULL);             // Read-only
+static struct kobj_attribute cgroup_count_attribute = __ATTR(count, 0444, cgroup_count_show, NULL);             // Read-only
+
+static struct attribute *cgroup_attrs[] = {
+    &cgroup_root_attribute.attr,
+    &cgroup_stats_attribute.attr,
+    &cgroup_count_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group cgroup_attr_group = {
+    .name = "cgroup",
+    .attrs = cgroup_attrs,
+};
+
+static struct monitor_source cgroup_source = {
+    .name = "cgroup",
+    .init = cgroup_source_init,
+    .exit = cgroup_source_exit,
+    .sample = cgroup_source_sample,
+    .summary = cgroup_source_summary,
+    .attr_group = &cgroup_attr_group,
+};
+
+// Task Tracker Source (optional, off by default)
+// Walks all processes once per TASKS_SAMPLE_INTERVAL_MS and keeps the top-N by CPU time delta and by RSS in
+// two bounded min-heaps, so the current offenders are already at hand when an alert fires. Per-process CPU
+// time from the previous walk is kept in a hash table keyed by pid, pruned by generation. The walk drops
+// the RCU read lock every TASKS_WALK_BATCH processes and tops up preallocated entries there, so it never
+// allocates atomically and never holds off RCU for the whole process list.
+#define TASKS_HASH_BITS 10
+#define TASKS_MAX_TRACKED 65536
+#define TASKS_SAMPLE_INTERVAL_MS 1000   // The walk is O(threads) under monitor_config_mutex, keep it off the 100 ms path
+#define TASKS_WALK_BATCH 256            // Processes visited per RCU read-side section
+#define TASKS_SPARE_MIN 64              // Entries kept preallocated for processes that appear during a batch
+
+struct task_history {
+    struct hlist_node node;
+    pid_t pid;
+    u64 start_time;             // Detects pid reuse
+    u64 runtime_ns;
+    unsigned long generation;
+};
+
+static DEFINE_HASHTABLE(tasks_table, TASKS_HASH_BITS);
+static HLIST_HEAD(tasks_spare);     // Zeroed entries allocated outside the walk
+static unsigned long tasks_spare_count;
+static unsigned long tasks_count;
+static unsigned long tasks_generation;
+static bool tasks_enabled;
+static ktime_t tasks_last_sample;
+
+// Heaps are min-heaps on the ranking key during the walk, so the smallest kept entry is at [0]
+struct top_heap_slot {
+    u64 key;
+    struct top_task task;
+};
+
+static struct top_heap_slot tasks_cpu_heap[TOP_TASKS_N];
+static struct top_heap_slot tasks_rss_heap[TOP_TASKS_N];
+static int tasks_cpu_heap_len, tasks_rss_heap_len;
+
+static void top_heap_sift_down(struct top_heap_slot *heap, int len, int i)
+{
+    for (;;) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        struct top_heap_slot tmp;
+
+        if (left < len && heap[left].key < heap[smallest].key)
+            smallest = left;
+        if (right < len && heap[right].key < heap[smallest].key)
+            smallest = right;
+        if (smallest == i)
+            return;
+        tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void top_heap_sift_up(struct top_heap_slot *heap, int i)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        struct top_heap_slot tmp;
+
+        if (heap[parent].key <= heap[i].key)
+            return;
+        tmp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+// Keep the TOP_TASKS_N largest entries: O(log N) per candidate, O(1) when it doesn't qualify
+static void top_heap_push(struct top_heap_slot *heap, int *len, const struct top_task *task, u64 key)
+{
+    if (*len < TOP_TASKS_N) {
+        heap[*len].key = key;
+        heap[*len].task = *task;
+        top_heap_sift_up(heap, (*len)++);
+    } else if (key > heap[0].key) {
+        heap[0].key = key;
+        heap[0].task = *task;
+        top_heap_sift_down(heap, *len, 0);
+    }
+}
+
+// Drain a min-heap into out[] highest first
+static int top_heap_drain(struct top_heap_slot *heap, int len, struct top_task *out)
+{
+    int count = len;
+
+    while (len > 0) {
+        out[len - 1] = heap[0].task;
+        heap[0] = heap[--len];
+        top_heap_sift_down(heap, len, 0);
+    }
+    return count;
+}
+
+static struct task_history *tasks_lookup(pid_t pid)
+{
+    struct task_history *hist;
+
+    hash_for_each_possible(tasks_table, hist, node, pid) {
+        if (hist->pid == pid)
+            return hist;
+    }
+    return NULL;
+}
+
+static void tasks_clear_table(void)
+{
+    struct task_history *hist;
+    struct hlist_node *tmp;
+    int bkt;
+
+    hash_for_each_safe(tasks_table, bkt, tmp, hist, node) {
+        hash_del(&hist->node);
+        kfree(hist);
+    }
+    tasks_count = 0;
+    top_cpu_count = 0;
+    top_rss_count = 0;
+}
+
+// Top up the spare entries with sleeping allocations; wanted is how many new processes the last batch had
+// no entry for
+static void tasks_refill_spare(unsigned long wanted)
+{
+    struct task_history *hist;
+    unsigned long target = min(max(wanted, (unsigned long)TASKS_SPARE_MIN), TASKS_MAX_TRACKED - tasks_count);
+
+    while (tasks_spare_count < target) {
+        hist = kzalloc(sizeof(*hist), GFP_KERNEL);
+        if (!hist)
+            break;
+        hlist_add_head(&hist->node, &tasks_spare);
+        tasks_spare_count++;
+    }
+}
+
+static void tasks_free_spare(void)
+{
+    struct task_history *hist;
+    struct hlist_node *tmp;
+
+    hlist_for_each_entry_safe(hist, tmp, &tasks_spare, node) {
+        hlist_del(&hist->node);
+        kfree(hist);
+    }
+    tasks_spare_count = 0;
+}
+
+// Leave the RCU read-side section between batches, the same way the hung task detector does. Returns false
+// when the process the walk stopped at exited meanwhile, its list linkage can no longer be followed.
+static bool tasks_walk_break(struct task_struct *p, unsigned long missing)
+{
+    bool alive;
+
+    get_task_struct(p);
+    rcu_read_unlock();
+    tasks_refill_spare(missing);
+    cond_resched();
+    rcu_read_lock();
+    alive = pid_alive(p);
+    put_task_struct(p);
+    return alive;
+}
+
+static void tasks_source_sample(ktime_t now)
+{
+    struct task_struct *p, *t;
+    struct task_history *hist;
+    struct hlist_node *tmp;
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, tasks_last_sample));
+    unsigned long missing = 0, batch = 0;
+    bool complete = true;
+    int bkt;
+
+    if (!tasks_enabled || elapsed_ns < (s64)TASKS_SAMPLE_INTERVAL_MS * NSEC_PER_MSEC)
+        return;
+
+    tasks_generation++;
+    tasks_cpu_heap_len = 0;
+    tasks_rss_heap_len = 0;
+    tasks_refill_spare(0);
+
+    rcu_read_lock();
+    for_each_process(p) {
+        struct top_task candidate;
+        u64 runtime;
+
+        if (++batch >= TASKS_WALK_BATCH) {
+            batch = 0;
+            if (!tasks_walk_break(p, missing)) {
+                complete = false;
+                break;
+            }
+            missing = 0;
+        }
+
+        if (p->flags & PF_KTHREAD)
+            continue;
+
+        // Thread group CPU time: exited threads plus live ones
+        runtime = READ_ONCE(p->signal->sum_sched_runtime);
+        for_each_thread(p, t)
+            runtime += READ_ONCE(t->se.sum_exec_runtime);
+
+        hist = tasks_lookup(p->pid);
+        if (hist && hist->start_time != p->start_time) {
+            // pid was reused, start over
+            hist->start_time = p->start_time;
+            hist->runtime_ns = runtime;
+        }
+        if (!hist) {
+            if (tasks_count >= TASKS_MAX_TRACKED)
+                continue;
+            // No allocating inside the RCU walk, take a spare or pick the process up next sample
+            if (hlist_empty(&tasks_spare)) {
+                missing++;
+                continue;
+            }
+            hist = hlist_entry(tasks_spare.first, struct task_history, node);
+            hlist_del(&hist->node);
+            tasks_spare_count--;
+            hist->pid = p->pid;
+            hist->start_time = p->start_time;
+            hist->runtime_ns = runtime;
+            hash_add(tasks_table, &hist->node, p->pid);
+            tasks_count++;
+        }
+        hist->generation = tasks_generation;
+
+        memset(&candidate, 0, sizeof(candidate));
+        candidate.pid = p->pid;
+        get_task_comm(candidate.comm, p);
+        candidate.cpu_delta_ns = runtime - hist->runtime_ns;
+        candidate.cpu_pct = elapsed_ns > 0 ? div64_u64(candidate.cpu_delta_ns * 100, elapsed_ns) : 0;
+        hist->runtime_ns = runtime;
+
+        // task_lock keeps p->mm from being torn down while we read its counters
+        task_lock(p);
+        if (p->mm)
+            candidate.rss_kb = get_mm_rss(p->mm) << (PAGE_SHIFT - 10);
+        task_unlock(p);
+
+        if (candidate.cpu_delta_ns)
+            top_heap_push(tasks_cpu_heap, &tasks_cpu_heap_len, &candidate, candidate.cpu_delta_ns);
+        if (candidate.rss_kb)
+            top_heap_push(tasks_rss_heap, &tasks_rss_heap_len, &candidate, candidate.rss_kb);
+    }
+    rcu_read_unlock();
+
+    // Forget processes that exited. A walk cut short did not see every live process, keep what it missed.
+    hash_for_each_safe(tasks_table, bkt, tmp, hist, node) {
+        if (complete && hist->generation != tasks_generation) {
+            hash_del(&hist->node);
+            kfree(hist);
+            tasks_count--;
+        }
+    }
+
+    top_cpu_count = top_heap_drain(tasks_cpu_heap, tasks_cpu_heap_len, top_cpu_tasks);
+    top_rss_count = top_heap_drain(tasks_rss_heap, tasks_rss_heap_len, top_rss_tasks);
+    tasks_refill_spare(missing);
+    tasks_last_sample = now;
+}
+
+static int tasks_source_summary(char *buf, size_t size)
+{
+    if (!tasks_enabled || !top_cpu_count)
+        return 0;
+    return scnprintf(buf, size, "Top Task: %s (%d) %lu%% CPU, %lu KiB RSS\n",
+                     top_cpu_tasks[0].comm, top_cpu_tasks[0].pid, top_cpu_tasks[0].cpu_pct, top_cpu_tasks[0].rss_kb);
+}
+
+static void tasks_source_exit(void)
+{
+    tasks_clear_table();
+    tasks_free_spare();
+}
+
+static ssize_t top_tasks_format(char *buf, ssize_t len, const char *title, const struct top_task *tasks, int count)
+{
+    int i;
+
+    len += scnprintf(buf + len, PAGE_SIZE - len, "%s\npid comm cpu%% rss_kb\n", title);
+    for (i = 0; i < count; i++)
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d %s %lu %lu\n",
+                         tasks[i].pid, tasks[i].comm, tasks[i].cpu_pct, tasks[i].rss_kb);
+    return len;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/tasks/
+static ssize_t tasks_enabled_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    return sprintf(buf, "%d\n", READ_ONCE(tasks_enabled));
+}
+
+static ssize_t tasks_enabled_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    bool enable;
+
+    if (kstrtobool(buf, &enable) < 0)
+        return -EINVAL;
+
+    mutex_lock(&monitor_config_mutex);
+    if (!enable) {
+        tasks_clear_table();
+        tasks_free_spare();
+    }
+    tasks_enabled = enable;
+    mutex_unlock(&monitor_config_mutex);
+
+    printk(KERN_INFO "%s: Task tracker %s\n", DEVICE_NAME, enable ? "enabled" : "disabled");
+    return count;
+}
+
+static ssize_t tasks_top_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+
+    mutex_lock(&monitor_config_mutex);
+    len = top_tasks_format(buf, len, "By CPU:", top_cpu_tasks, top_cpu_count);
+    len = top_tasks_format(buf, len, "By RSS:", top_rss_tasks, top_rss_count);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t tasks_last_alert_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+
+    mutex_lock(&monitor_config_mutex);
+    if (!last_alert.time) {
+        mutex_unlock(&monitor_config_mutex);
+        return sprintf(buf, "none\n");
+    }
+    len += scnprintf(buf + len, PAGE_SIZE - len, "Reason: %s\nAge: %lld ms\nValue: %lu\nResource Factor: %lu\n",
+                     last_alert.reason, ktime_ms_delta(ktime_get(), last_alert.time),
+                     last_alert.value, last_alert.resource_factor);
+    len = top_tasks_format(buf, len, "By CPU:", last_alert.cpu_tasks, last_alert.nr_cpu_tasks);
+    len = top_tasks_format(buf, len, "By RSS:", last_alert.rss_tasks, last_alert.nr_rss_tasks);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static struct kobj_attribute tasks_enabled_attribute = __ATTR(enabled, 0664, tasks_enabled_show, tasks_enabled_store);  // Read/Write
+static struct kobj_attribute tasks_top_attribute = __ATTR(top, 0444, tasks_top_show, NULL);                             // Read-only
+static struct kobj_attribute tasks_last_alert_attribute = __ATTR(last_alert, 0444, tasks_last_alert_show, NULL);        // Read-only
+
+static struct attribute *tasks_attrs[] = {
+    &tasks_enabled_attribute.attr,
+    &tasks_top_attribute.attr,
+    &tasks_last_alert_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group tasks_attr_group = {
+    .name = "tasks",
+    .attrs = tasks_attrs,
+};
+
+static struct monitor_source tasks_source = {
+    .name = "tasks",
+    .exit = tasks_source_exit,
+    .sample = tasks_source_sample,
+    .summary = tasks_source_summary,
+    .attr_group = &tasks_attr_group,
+};
+
+// Watched PID Source
+// Critical services registered through ioctl are sampled every tick: CPU time, run-queue delay and
+// voluntary/involuntary switches summed over their threads. Holding a struct pid reference keeps the
+// registration bound to the original process even if its pid number is later reused. Starvation is the
+// run-queue delay per thread that was runnable during the interval, so a service with many threads
+// waiting a little each is not reported as starved.
+#define WATCH_MAX_PIDS 64
+#define WATCH_STARVATION_PCT 20     // Run-queue wait share at which a watched service counts as starved
+
+struct watch_entry {
+    struct pid *pid;
+    pid_t nr;                   // pid number in the registering namespace
+    bool alive;
+    bool primed;
+    char comm[TASK_COMM_LEN];
+    // Raw totals from the last sample
+    u64 cpu_time_ns;
+    u64 run_delay_ns;
+    u64 nvcsw, nivcsw;
+    // Derived over the last interval
+    unsigned long cpu_pct;
+    unsigned long starvation_pct;
+    unsigned long nvcsw_ps, nivcsw_ps;
+};
+
+static struct watch_entry watch_entries[WATCH_MAX_PIDS];
+static int watch_count;
+static ktime_t watch_last_sample;
+static u64 watch_last_clock;        // local_clock() at the last sample, the clock sched_info timestamps use
+
+static void watch_sample_entry(struct watch_entry *entry, s64 elapsed_ns, u64 since_clock)
+{
+    struct task_struct *p, *t;
+    u64 cpu_time, run_delay = 0, nvcsw, nivcsw;
+    unsigned int runnable = 0;
+
+    rcu_read_lock();
+    p = pid_task(entry->pid, PIDTYPE_TGID);
+    if (!p) {
+        rcu_read_unlock();
+        if (entry->alive)
+            printk(KERN_WARNING "%s: Watched process %s (%d) exited\n", DEVICE_NAME, entry->comm, entry->nr);
+        entry->alive = false;
+        entry->cpu_pct = entry->starvation_pct = entry->nvcsw_ps = entry->nivcsw_ps = 0;
+        return;
+    }
+
+    // Totals of exited threads live in signal_struct, add the live ones
+    cpu_time = READ_ONCE(p->signal->sum_sched_runtime);
+    nvcsw = READ_ONCE(p->signal->nvcsw);
+    nivcsw = READ_ONCE(p->signal->nivcsw);
+    for_each_thread(p, t) {
+        cpu_time += READ_ONCE(t->se.sum_exec_runtime);
+#ifdef CONFIG_SCHED_INFO
+        run_delay += READ_ONCE(t->sched_info.run_delay);
+        // Runnable at some point since the last sample: queued now, or dispatched since then
+        if (READ_ONCE(t->__state) == TASK_RUNNING || READ_ONCE(t->sched_info.last_arrival) >= since_clock)
+            runnable++;
+#endif
+        nvcsw += READ_ONCE(t->nvcsw);
+        nivcsw += READ_ONCE(t->nivcsw);
+    }
+    get_task_comm(entry->comm, p);
+    rcu_read_unlock();
+
+    // run_delay of exited threads is not kept in signal_struct, so totals can drop between samples; only count growth
+    if (entry->primed && elapsed_ns > 0) {
+        entry->cpu_pct = cpu_time > entry->cpu_time_ns ? div64_u64((cpu_time - entry->cpu_time_ns) * 100, elapsed_ns) : 0;
+        entry->starvation_pct = run_delay > entry->run_delay_ns ?
+                                min_t(u64, div64_u64((run_delay - entry->run_delay_ns) * 100,
+                                                     (u64)elapsed_ns * max(runnable, 1U)), 100) : 0;
+        entry->nvcsw_ps = nvcsw > entry->nvcsw ? div64_u64((nvcsw - entry->nvcsw) * NSEC_PER_SEC, elapsed_ns) : 0;
+        entry->nivcsw_ps = nivcsw > entry->nivcsw ? div64_u64((nivcsw - entry->nivcsw) * NSEC_PER_SEC, elapsed_ns) : 0;
+    }
+    entry->cpu_time_ns = cpu_time;
+    entry->run_delay_ns = run_delay;
+    entry->nvcsw = nvcsw;
+    entry->nivcsw = nivcsw;
+    entry->alive = true;
+    entry->primed = true;
+}
+
+static void watch_source_sample(ktime_t now)
+{
+    s64 elapsed_ns = ktime_to_ns(ktime_sub(now, watch_last_sample));
+    u64 clock = local_clock();
+    unsigned long starved = 0;
+    int i;
+
+    for (i = 0; i < watch_count; i++) {
+        watch_sample_entry(&watch_entries[i], elapsed_ns, watch_last_clock);
+        starved = max(starved, watch_entries[i].starvation_pct);
+    }
+
+    watch_last_sample = now;
+    watch_last_clock = clock;
+    monitor_state.watch_starvation = starved;
+}
+
+static int watch_source_summary(char *buf, size_t size)
+{
+    if (!watch_count)
+        return 0;
+    return scnprintf(buf, size, "Watched PIDs: %d, Worst Starvation %lu%%\n", watch_count, monitor_state.watch_starvation);
+}
+
+static void watch_source_exit(void)
+{
+    int i;
+
+    for (i = 0; i < watch_count; i++)
+        put_pid(watch_entries[i].pid);
+    watch_count = 0;
+}
+
+static int watch_find(pid_t nr)
+{
+    int i;
+
+    for (i = 0; i < watch_count; i++) {
+        if (watch_entries[i].nr == nr)
+            return i;
+    }
+    return -1;
+}
+
+// ioctl: AUTO_MONITOR_IOC_WATCH_ADD
+static long watch_ioctl_add(s32 __user *uarg)
+{
+    struct watch_entry *entry;
+    struct task_struct *task;
+    struct pid *pid;
+    s32 nr;
+    long ret = 0;
+
+    if (get_user(nr, uarg))
+        return -EFAULT;
+    if (nr <= 0)
+        return -EINVAL;
+
+    // Resolved in the caller's PID namespace
+    pid = find_get_pid(nr);
+    if (!pid)
+        return -ESRCH;
+    task = get_pid_task(pid, PIDTYPE_TGID);
+    if (!task) {
+        put_pid(pid);
+        return -ESRCH;
+    }
+
+    mutex_lock(&monitor_config_mutex);
+    if (watch_find(nr) >= 0) {
+        ret = -EEXIST;
+    } else if (watch_count >= WATCH_MAX_PIDS) {
+        ret = -ENOSPC;
+    } else {
+        entry = &watch_entries[watch_count++];
+        memset(entry, 0, sizeof(*entry));
+        entry->pid = pid;
+        entry->nr = nr;
+        entry->alive = true;
+        get_task_comm(entry->comm, task);
+        pid = NULL;     // Reference now owned by the entry
+    }
+    mutex_unlock(&monitor_config_mutex);
+
+    if (!ret)
+        printk(KERN_INFO "%s: Watching %s (%d)\n", DEVICE_NAME, task->comm, nr);
+    put_task_struct(task);
+    put_pid(pid);
+    return ret;
+}
+
+// ioctl: AUTO_MONITOR_IOC_WATCH_DEL
+static long watch_ioctl_del(s32 __user *uarg)
+{
+    struct pid *pid = NULL;
+    s32 nr;
+    int i;
+
+    if (get_user(nr, uarg))
+        return -EFAULT;
+
+    mutex_lock(&monitor_config_mutex);
+    i = watch_find(nr);
+    if (i >= 0) {
+        pid = watch_entries[i].pid;
+        watch_entries[i] = watch_entries[--watch_count];
+    }
+    mutex_unlock(&monitor_config_mutex);
+
+    if (!pid)
+        return -ENOENT;
+    put_pid(pid);
+    printk(KERN_INFO "%s: Stopped watching %d\n", DEVICE_NAME, nr);
+    return 0;
+}
+
+// ioctl: AUTO_MONITOR_IOC_WATCH_LIST
+static long watch_ioctl_list(struct auto_monitor_watch_list __user *uarg)
+{
+    struct auto_monitor_watch_stat *stats;
+    struct auto_monitor_watch_list list;
+    u32 count;
+    long ret = 0;
+    int i;
+
+    if (copy_from_user(&list, uarg, sizeof(list)))
+        return -EFAULT;
+
+    // Snapshot under the mutex, copy to user-space after dropping it
+    stats = kcalloc(WATCH_MAX_PIDS, sizeof(*stats), GFP_KERNEL);
+    if (!stats)
+        return -ENOMEM;
+
+    mutex_lock(&monitor_config_mutex);
+    count = min_t(u32, list.capacity, watch_count);
+    for (i = 0; i < count; i++) {
+        struct watch_entry *entry = &watch_entries[i];
+
+        stats[i].pid = entry->nr;
+        stats[i].alive = entry->alive;
+        stats[i].cpu_time_ns = entry->cpu_time_ns;
+        stats[i].run_delay_ns = entry->run_delay_ns;
+        stats[i].nvcsw = entry->nvcsw;
+        stats[i].nivcsw = entry->nivcsw;
+        stats[i].cpu_pct = entry->cpu_pct;
+        stats[i].starvation_pct = entry->starvation_pct;
+        stats[i].nvcsw_ps = entry->nvcsw_ps;
+        stats[i].nivcsw_ps = entry->nivcsw_ps;
+        strscpy(stats[i].comm, entry->comm, sizeof(stats[i].comm));
+    }
+    list.total = watch_count;
+    mutex_unlock(&monitor_config_mutex);
+
+    list.count = count;
+    if (count && copy_to_user(u64_to_user_ptr(list.entries), stats, count * sizeof(*stats)))
+        ret = -EFAULT;
+    else if (copy_to_user(uarg, &list, sizeof(list)))
+        ret = -EFAULT;
+
+    kfree(stats);
+    return ret;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/watch/
+static ssize_t watch_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "pid comm alive cpu%% starvation%% nvcsw_ps nivcsw_ps\n");
+    for (i = 0; i < watch_count; i++) {
+        struct watch_entry *entry = &watch_entries[i];
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%d %s %d %lu %lu %lu %lu\n",
+                         entry->nr, entry->comm, entry->alive, entry->cpu_pct, entry->starvation_pct,
+                         entry->nvcsw_ps, entry->nivcsw_ps);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t watch_starvation_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long starvation;
+    mutex_lock(&monitor_config_mutex);
+    starvation = monitor_state.watch_starvation;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", starvation);
+}
+
+static struct kobj_attribute watch_stats_attribute = __ATTR(stats, 0444, watch_stats_show, NULL);                   // Read-only
+static struct kobj_attribute watch_starvation_attribute = __ATTR(starvation, 0444, watch_starvation_show, NULL);    // Read-only
+
+static struct attribute *watch_attrs[] = {
+    &watch_stats_attribute.attr,
+    &watch_starvation_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group watch_attr_group = {
+    .name = "watch",
+    .attrs = watch_attrs,
+};
+
+static struct monitor_source watch_source = {
+    .name = "watch",
+    .exit = watch_source_exit,
+    .sample = watch_source_sample,
+    .summary = watch_source_summary,
+    .attr_group = &watch_attr_group,
+};
+
+// SLO Source
+// Applications publish per-window latency and throughput (ioctl, or "slo ..." writes to /dev/auto_monitor).
+// Reports are aggregated per reporter over its last few windows; the worst fresh p99 across reporters
+// lets the adjuster steer on a latency target instead of the utilization band.
+#define SLO_MAX_REPORTERS 32
+#define SLO_HISTORY 8               // Windows aggregated per reporter
+#define SLO_STALE_MS 10000          // Reporters silent for longer are ignored
+#define SLO_RELAX_PCT 50            // Scale down only once p99 is below this % of the target
+
+struct slo_window {
+    u32 window_ms;
+    u32 p50_us, p99_us;
+    u64 requests;
+};
+
+struct slo_reporter {
+    char name[AUTO_MONITOR_SLO_NAME_LEN];
+    ktime_t last_report;
+    unsigned long reports;
+    struct slo_window history[SLO_HISTORY];     // Ring, newest at (head - 1)
+    int head, len;
+    // Aggregates over the history
+    u32 p50_us;                 // Mean of window medians
+    u32 p99_us;                 // Worst window p99 (conservative)
+    unsigned long throughput;   // Requests per second
+};
+
+static struct slo_reporter slo_reporters[SLO_MAX_REPORTERS];
+static int slo_reporter_count;
+static unsigned long slo_target_p99_us;             // 0 = utilization band
+static unsigned long slo_rejected;                  // Reports dropped (table full or invalid)
+
+static void slo_aggregate(struct slo_reporter *rep)
+{
+    u64 p50_sum = 0, requests = 0, window_ms = 0;
+    u32 p99 = 0;
+    int i;
+
+    for (i = 0; i < rep->len; i++) {
+        struct slo_window *w = &rep->history[i];
+        p50_sum += w->p50_us;
+        p99 = max(p99, w->p99_us);
+        requests += w->requests;
+        window_ms += w->window_ms;
+    }
+    rep->p50_us = rep->len ? div_u64(p50_sum, rep->len) : 0;
+    rep->p99_us = p99;
+    rep->throughput = window_ms ? div64_u64(requests * MSEC_PER_SEC, window_ms) : 0;
+}
+
+// Called with monitor_config_mutex held
+static int slo_record(const struct auto_monitor_slo_report *report)
+{
+    struct slo_reporter *rep = NULL;
+    int i;
+
+    if (!report->window_ms || !report->name[0]) {
+        slo_rejected++;
+        return -EINVAL;
+    }
+
+    for (i = 0; i < slo_reporter_count; i++) {
+        if (strcmp(slo_reporters[i].name, report->name) == 0) {
+            rep = &slo_reporters[i];
+            break;
+        }
+    }
+    if (!rep) {
+        // Reuse the slot of a reporter that went stale before giving up
+        for (i = 0; i < slo_reporter_count; i++) {
+            if (ktime_ms_delta(ktime_get(), slo_reporters[i].last_report) > SLO_STALE_MS) {
+                rep = &slo_reporters[i];
+                break;
+            }
+        }
+        if (!rep && slo_reporter_count < SLO_MAX_REPORTERS)
+            rep = &slo_reporters[slo_reporter_count++];
+        if (!rep) {
+            slo_rejected++;
+            return -ENOSPC;
+        }
+        memset(rep, 0, sizeof(*rep));
+        strscpy(rep->name, report->name, sizeof(rep->name));
+    }
+
+    rep->history[rep->head].window_ms = report->window_ms;
+    rep->history[rep->head].p50_us = report->p50_us;
+    rep->history[rep->head].p99_us = report->p99_us;
+    rep->history[rep->head].requests = report->requests;
+    rep->head = (rep->head + 1) % SLO_HISTORY;
+    rep->len = min(rep->len + 1, SLO_HISTORY);
+    rep->last_report = ktime_get();
+    rep->reports++;
+    slo_aggregate(rep);
+    return 0;
+}
+
+// ioctl: AUTO_MONITOR_IOC_SLO_REPORT
+static long slo_ioctl_report(struct auto_monitor_slo_report __user *uarg)
+{
+    struct auto_monitor_slo_report report;
+    int ret;
+
+    if (copy_from_user(&report, uarg, sizeof(report)))
+        return -EFAULT;
+    report.name[sizeof(report.name) - 1] = '\0';
+    if (!report.name[0])
+        snprintf(report.name, sizeof(report.name), "pid:%d", task_tgid_vnr(current));
+
+    mutex_lock(&monitor_config_mutex);
+    ret = slo_record(&report);
+    mutex_unlock(&monitor_config_mutex);
+    return ret;
+}
+
+// Write channel: "slo <name> <window_ms> <p50_us> <p99_us> <requests>"
+static int slo_write_report(const char *cmd)
+{
+    struct auto_monitor_slo_report report;
+    int ret;
+
+    memset(&report, 0, sizeof(report));
+    if (sscanf(cmd, "%31s %u %u %u %llu", report.name, &report.window_ms,
+               &report.p50_us, &report.p99_us, &report.requests) != 5)
+        return -EINVAL;
+
+    mutex_lock(&monitor_config_mutex);
+    ret = slo_record(&report);
+    mutex_unlock(&monitor_config_mutex);
+    return ret;
+}
+
+static void slo_source_sample(ktime_t now)
+{
+    unsigned long worst = 0, throughput = 0;
+    int i;
+
+    for (i = 0; i < slo_reporter_count; i++) {
+        if (ktime_ms_delta(now, slo_reporters[i].last_report) <= SLO_STALE_MS) {
+            worst = max_t(unsigned long, worst, slo_reporters[i].p99_us);
+            throughput += slo_reporters[i].throughput;
+        }
+    }
+    monitor_state.slo_p99_us = worst;
+    monitor_state.slo_throughput = throughput;
+}
+
+static int slo_source_summary(char *buf, size_t size)
+{
+    if (!slo_reporter_count && !slo_target_p99_us)
+        return 0;
+    return scnprintf(buf, size, "SLO: Worst p99 %lu us, Target %lu us%s, Reporters %d\n",
+                     monitor_state.slo_p99_us, slo_target_p99_us,
+                     slo_target_p99_us ? "" : " (off)", slo_reporter_count);
+}
+
+// Sysfs: /sys/kernel/auto_monitor/slo/
+static ssize_t slo_target_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long target;
+    mutex_lock(&monitor_config_mutex);
+    target = slo_target_p99_us;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", target);
+}
+
+static ssize_t slo_target_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    unsigned long target;
+
+    // p99 target in microseconds, 0 returns to the utilization band
+    if (kstrtoul(buf, 10, &target) < 0)
+        return -EINVAL;
+
+    mutex_lock(&monitor_config_mutex);
+    slo_target_p99_us = target;
+    mutex_unlock(&monitor_config_mutex);
+
+    printk(KERN_INFO "%s: SLO p99 target set to %lu us\n", DEVICE_NAME, target);
+    return count;
+}
+
+static ssize_t slo_reporters_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ktime_t now = ktime_get();
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "name reports p50_us p99_us req_per_s age_ms\n");
+    for (i = 0; i < slo_reporter_count; i++) {
+        struct slo_reporter *rep = &slo_reporters[i];
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %lu %u %u %lu %lld\n",
+                         rep->name, rep->reports, rep->p50_us, rep->p99_us, rep->throughput,
+                         ktime_ms_delta(now, rep->last_report));
+    }
+    len += scnprintf(buf + len, PAGE_SIZE - len, "rejected %lu\n", slo_rejected);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t slo_p99_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    unsigned long p99;
+    mutex_lock(&monitor_config_mutex);
+    p99 = monitor_state.slo_p99_us;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", p99);
+}
+
+static struct kobj_attribute slo_target_attribute = __ATTR(target_p99_us, 0664, slo_target_show, slo_target_store);    // Read/Write
+static struct kobj_attribute slo_reporters_attribute = __ATTR(reporters, 0444, slo_reporters_show, NULL);              // Read-only
+static struct kobj_attribute slo_p99_attribute = __ATTR(p99_us, 0444, slo_p99_show, NULL);                             // Read-only
+
+static struct attribute *slo_attrs[] = {
+    &slo_target_attribute.attr,
+    &slo_reporters_attribute.attr,
+    &slo_p99_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group slo_attr_group = {
+    .name = "slo",
+    .attrs = slo_attrs,
+};
+
+static struct monitor_source slo_source = {
+    .name = "slo",
+    .sample = slo_source_sample,
+    .summary = slo_source_summary,
+    .attr_group = &slo_attr_group,
+};
+
+// Metric Ring Source
+// Drains the shared-memory rings producers fill with plain stores, so high-rate reporting costs no
+// syscalls. Latency records go into a per-ring log-linear histogram; once per window the ring's
+// p50/p99 and request count are published as an SLO report under the ring's name.
+#define RING_MAX 64
+#define RING_MIN_CAPACITY 64
+#define RING_MAX_CAPACITY (1 << 16)
+#define RING_WINDOW_MS 1000
+#define RING_BACKPRESSURE_ON_PCT 75     // Fill level after a drain that raises the backpressure flag
+#define RING_BACKPRESSURE_OFF_PCT 25    // Fill level that clears it again
+#define RING_HIST_SUB_BITS 3            // 8 linear sub-buckets per power of two (~12% resolution)
+#define RING_HIST_BUCKETS (64 << RING_HIST_SUB_BITS)
+
+struct metric_ring {
+    struct list_head node;
+    char name[AUTO_MONITOR_SLO_NAME_LEN];
+    struct auto_monitor_ring_header *hdr;       // Start of the vmalloc_user() area shared with the producer
+    struct auto_monitor_metric_record *records;
+    size_t size;
+    u32 mask;
+    ktime_t window_start;
+    u64 window_requests;
+    u64 window_samples;
+    u32 hist[RING_HIST_BUCKETS];
+};
+
+static LIST_HEAD(ring_list);
+static int ring_count;
+
+// Log-linear bucket: exact below 2^RING_HIST_SUB_BITS, then 2^RING_HIST_SUB_BITS buckets per power of two
+static int ring_hist_bucket(u64 value)
+{
+    int msb;
+
+    if (value < (1 << RING_HIST_SUB_BITS))
+        return value;
+    msb = fls64(value) - 1;
+    return ((msb - RING_HIST_SUB_BITS + 1) << RING_HIST_SUB_BITS) +
+           ((value >> (msb - RING_HIST_SUB_BITS)) & ((1 << RING_HIST_SUB_BITS) - 1));
+}
+
+// Upper bound of a bucket, so reported percentiles err on the pessimistic side
+static u64 ring_hist_value(int bucket)
+{
+    int group = bucket >> RING_HIST_SUB_BITS;
+    u64 sub = bucket & ((1 << RING_HIST_SUB_BITS) - 1);
+
+    if (!group)
+        return sub;
+    return (((1ULL << RING_HIST_SUB_BITS) + sub + 1) << (group - 1)) - 1;
+}
+
+static u64 ring_hist_percentile(struct metric_ring *ring, unsigned int pct)
+{
+    u64 rank = div_u64(ring->window_samples * pct + 99, 100);
+    u64 seen = 0;
+    int i;
+
+    for (i = 0; i < RING_HIST_BUCKETS; i++) {
+        seen += ring->hist[i];
+        if (seen >= rank && seen)
+            return ring_hist_value(i);
+    }
+    return 0;
+}
+
+static void ring_close_window(struct metric_ring *ring, ktime_t now)
+{
+    struct auto_monitor_slo_report report;
+    s64 window_ms = ktime_ms_delta(now, ring->window_start);
+
+    if (ring->window_requests || ring->window_samples) {
+        memset(&report, 0, sizeof(report));
+        strscpy(report.name, ring->name, sizeof(report.name));
+        report.window_ms = window_ms;
+        report.p50_us = min_t(u64, ring_hist_percentile(ring, 50), U32_MAX);
+        report.p99_us = min_t(u64, ring_hist_percentile(ring, 99), U32_MAX);
+        report.requests = ring->window_requests;
+        slo_record(&report);
+    }
+
+    memset(ring->hist, 0, sizeof(ring->hist));
+    ring->window_requests = 0;
+    ring->window_samples = 0;
+    ring->window_start = now;
+}
+
+static void ring_drain(struct metric_ring *ring)
+{
+    struct auto_monitor_ring_header *hdr = ring->hdr;
+    u32 head, tail, fill;
+    u64 consumed = 0, invalid = 0;
+
+    // Pairs with the producer's release store of head
+    head = smp_load_acquire(&hdr->head);
+    tail = ring->hdr->tail;
+
+    // The header is writable by user-space, never trust it beyond the ring size
+    if (head - tail > ring->mask + 1) {
+        invalid += head - tail;
+        tail = head;
+    }
+
+    while (tail != head) {
+        struct auto_monitor_metric_record *slot = &ring->records[tail & ring->mask];
+        u32 kind = READ_ONCE(slot->kind);
+        u64 value = READ_ONCE(slot->value);
+
+        switch (kind) {
+        case AUTO_MONITOR_METRIC_LATENCY_US:
+            ring->hist[min(ring_hist_bucket(value), RING_HIST_BUCKETS - 1)]++;
+            ring->window_samples++;
+            ring->window_requests++;
+            break;
+        case AUTO_MONITOR_METRIC_REQUESTS:
+            ring->window_requests += value;
+            break;
+        default:
+            invalid++;
+            break;
+        }
+        consumed++;
+        tail++;
+    }
+
+    // Release the slots back to the producer only after they have been read
+    smp_store_release(&hdr->tail, tail);
+    WRITE_ONCE(hdr->consumed, hdr->consumed + consumed);
+    WRITE_ONCE(hdr->invalid, hdr->invalid + invalid);
+
+    // Backpressure reflects how full the ring was when we got to it
+    fill = div_u64((u64)consumed * 100, ring->mask + 1);
+    if (fill >= RING_BACKPRESSURE_ON_PCT)
+        WRITE_ONCE(hdr->flags, hdr->flags | AUTO_MONITOR_RING_BACKPRESSURE);
+    else if (fill <= RING_BACKPRESSURE_OFF_PCT)
+        WRITE_ONCE(hdr->flags, hdr->flags & ~AUTO_MONITOR_RING_BACKPRESSURE);
+}
+
+static void ring_source_sample(ktime_t now)
+{
+    struct metric_ring *ring;
+
+    list_for_each_entry(ring, &ring_list, node) {
+        ring_drain(ring);
+        if (ktime_ms_delta(now, ring->window_start) >= RING_WINDOW_MS)
+            ring_close_window(ring, now);
+    }
+}
+
+static int ring_source_summary(char *buf, size_t size)
+{
+    struct metric_ring *ring;
+    u64 consumed = 0, overflow = 0;
+
+    if (!ring_count)
+        return 0;
+    list_for_each_entry(ring, &ring_list, node) {
+        consumed += READ_ONCE(ring->hdr->consumed);
+        overflow += READ_ONCE(ring->hdr->overflow);
+    }
+    return scnprintf(buf, size, "Rings: %d, Records Consumed %llu, Producer Overflows %llu\n",
+                     ring_count, consumed, overflow);
+}
+
+// ioctl: AUTO_MONITOR_IOC_RING_CREATE (one ring per open file)
+static long ring_ioctl_create(struct file *file, struct auto_monitor_ring_create __user *uarg)
+{
+    struct auto_monitor_ring_create req;
+    struct metric_ring *ring;
+    u32 capacity;
+    long ret = 0;
+
+    if (copy_from_user(&req, uarg, sizeof(req)))
+        return -EFAULT;
+    req.name[sizeof(req.name) - 1] = '\0';
+    if (!req.name[0])
+        snprintf(req.name, sizeof(req.name), "pid:%d", task_tgid_vnr(current));
+    if (!req.capacity || req.capacity > RING_MAX_CAPACITY)
+        return -EINVAL;
+    capacity = roundup_pow_of_two(max_t(u32, req.capacity, RING_MIN_CAPACITY));
+
+    ring = kzalloc(sizeof(*ring), GFP_KERNEL);
+    if (!ring)
+        return -ENOMEM;
+    strscpy(ring->name, req.name, sizeof(ring->name));
+    ring->mask = capacity - 1;
+    // Header gets its own page so the record array starts page aligned
+    ring->size = PAGE_SIZE + PAGE_ALIGN(capacity * sizeof(struct auto_monitor_metric_record));
+    ring->hdr = vmalloc_user(ring->size);
+    if (!ring->hdr) {
+        kfree(ring);
+        return -ENOMEM;
+    }
+    ring->records = (void *)ring->hdr + PAGE_SIZE;
+    ring->hdr->capacity = capacity;
+    ring->hdr->records_offset = PAGE_SIZE;
+    ring->window_start = ktime_get();
+
+    mutex_lock(&monitor_config_mutex);
+    if (file->private_data)
+        ret = -EEXIST;
+    else if (ring_count >= RING_MAX)
+        ret = -ENOSPC;
+    else {
+        list_add_tail(&ring->node, &ring_list);
+        ring_count++;
+        file->private_data = ring;
+    }
+    mutex_unlock(&monitor_config_mutex);
+
+    if (ret) {
+        vfree(ring->hdr);
+        kfree(ring);
+        return ret;
+    }
+
+    req.capacity = capacity;
+    req.mmap_size = ring->size;
+    if (copy_to_user(uarg, &req, sizeof(req)))
+        return -EFAULT;
+    printk(KERN_INFO "%s: Metric ring \"%s\" created with %u slots\n", DEVICE_NAME, ring->name, capacity);
+    return 0;
+}
+
+static int ring_mmap(struct file *file, struct vm_area_struct *vma)
+{
+    struct metric_ring *ring = file->private_data;
+
+    if (!ring)
+        return -ENODEV;
+    if (vma->vm_pgoff || vma->vm_end - vma->vm_start != ring->size)
+        return -EINVAL;
+    // Mapping holds a file reference, so the ring outlives it (freed in release)
+    return remap_vmalloc_range(vma, ring->hdr, 0);
+}
+
+// Called from release once the last mapping and file reference are gone
+static void ring_destroy(struct metric_ring *ring)
+{
+    mutex_lock(&monitor_config_mutex);
+    // Fold what the producer left behind into a final report
+    ring_drain(ring);
+    ring_close_window(ring, ktime_get());
+    list_del(&ring->node);
+    ring_count--;
+    mutex_unlock(&monitor_config_mutex);
+
+    vfree(ring->hdr);
+    kfree(ring);
+}
+
+// Sysfs: /sys/kernel/auto_monitor/ring/
+static ssize_t ring_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct metric_ring *ring;
+    ssize_t len = 0;
+
+    mutex_lock(&monitor_config_mutex);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "name capacity pending consumed overflow invalid backpressure\n");
+    list_for_each_entry(ring, &ring_list, node) {
+        struct auto_monitor_ring_header *hdr = ring->hdr;
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %u %u %llu %llu %llu %d\n",
+                         ring->name, ring->mask + 1, READ_ONCE(hdr->head) - READ_ONCE(hdr->tail),
+                         READ_ONCE(hdr->consumed), READ_ONCE(hdr->overflow), READ_ONCE(hdr->invalid),
+                         !!(READ_ONCE(hdr->flags) & AUTO_MONITOR_RING_BACKPRESSURE));
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static struct kobj_attribute ring_stats_attribute = __ATTR(stats, 0444, ring_stats_show, NULL);     // Read-only
+
+static struct attribute *ring_attrs[] = {
+    &ring_stats_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group ring_attr_group = {
+    .name = "ring",
+    .attrs = ring_attrs,
+};
+
+static struct monitor_source ring_source = {
+    .name = "ring",
+    .sample = ring_source_sample,
+    .summary = ring_source_summary,
+    .attr_group = &ring_attr_group,
+};
+
+static struct monitor_source *monitor_sources[] = {
+    &io_source,
+    &net_source,
+    &irq_source,
+    &steal_source,
+    &mem_source,
+    &perf_source,
+    &cgroup_source,
+    &tasks_source,
+    &watch_source,
+    &ring_source,       // Before slo so drained windows count in the same sample
+    &slo_source,
+};
+
+static void monitor_sources_sample(ktime_t now)
+{
+    int i;
+
+    if (ktime_ms_delta(now, monitor_state.last_source_sample) < SOURCE_MIN_INTERVAL_MS)
+        return;
+    monitor_state.last_source_sample = now;
+
+    for (i = 0; i < ARRAY_SIZE(monitor_sources); i++)
+        monitor_sources[i]->sample(now);
+}
+
+static int monitor_sources_summary(char *buf, size_t size)
+{
+    int len = 0;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(monitor_sources); i++) {
+        if (monitor_sources[i]->summary)
+            len += monitor_sources[i]->summary(buf + len, size - len);
+    }
+    return len;
+}
+
+static void monitor_sources_exit(int count)
+{
+    // Tear down in reverse order of initialization
+    while (count-- > 0) {
+        struct monitor_source *src = monitor_sources[count];
+        if (src->attr_group)
+            sysfs_remove_group(auto_monitor_kobj, src->attr_group);
+        if (src->exit)
+            src->exit();
+    }
+}
+
+static int monitor_sources_init(void)
+{
+    int ret;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(monitor_sources); i++) {
+        struct monitor_source *src = monitor_sources[i];
+
+        ret = src->init ? src->init() : 0;
+        if (ret) {
+            printk(KERN_ALERT "%s: Failed to initialize %s source\n", DEVICE_NAME, src->name);
+            monitor_sources_exit(i);
+            return ret;
+        }
+        if (src->attr_group) {
+            ret = sysfs_create_group(auto_monitor_kobj, src->attr_group);
+            if (ret) {
+                printk(KERN_ALERT "%s: Failed to create %s sysfs group\n", DEVICE_NAME, src->name);
+                if (src->exit)
+                    src->exit();
+                monitor_sources_exit(i);
+                return ret;
+            }
+        }
+    }
+    return 0;
+}
+
+// Adjustment Policies (process context, monitor_config_mutex held)
+// The work handler gathers one snapshot of every signal and asks the active policy for the next resource
+// factor. Clamping, the host-contention guard and alerting stay in the handler so every policy gets them.
+
+// The workload the policies act on, given an estimate of the simulated one
+static unsigned long monitor_effective_workload(const struct monitor_inputs *in, unsigned long sim)
+{
+    // A saturated disk, link or memory reclaim counts as high load even if the simulated workload is not
+    unsigned long workload = max(max3(sim, in->io_utilization, in->net_utilization), in->reclaim_pressure);
+
+    // A starved critical service needs more resources regardless of the machine-wide averages
+    if (in->watch_starvation >= WATCH_STARVATION_PCT)
+        workload = max(workload, in->high_threshold + 1);
+    return workload;
+}
+
+// Signal Fusion
+// A two-state (load level, load rate) fixed-point Kalman filter over the simulated load, with a
+// constant-rate model. Each run it predicts forward by the elapsed timer periods, then folds in the
+// workload sample as a scalar measurement of the level. Only independent sensors may be fused: the
+// simulated temperature and memory pressure are fixed functions of the same workload sample, so adding
+// them would count one reading three times and make the reported stddev overconfident. The real
+// resource signals are combined in afterwards as usual.
+// State is in milli-percent, covariances in milli-percent squared, gains in 1/KALMAN_GAIN_SCALE.
+#define KALMAN_GAIN_SCALE 1000
+#define KALMAN_VAR_SCALE 1000000LL          // 1 %^2 in milli-percent squared
+#define KALMAN_MAX_STEPS 10                 // Prediction is capped after long gaps
+#define KALMAN_P_MAX (10000LL * KALMAN_VAR_SCALE)   // Never less certain than +/-100%
+#define KALMAN_DEFAULT_R_WORKLOAD 25        // %^2, sensor noise variance
+#define KALMAN_DEFAULT_Q_LEVEL 1000         // 1/1000 %^2 per timer period, process noise
+#define KALMAN_DEFAULT_Q_RATE 100
+
+static unsigned long kalman_r_workload = KALMAN_DEFAULT_R_WORKLOAD;
+static unsigned long kalman_q_level = KALMAN_DEFAULT_Q_LEVEL;
+static unsigned long kalman_q_rate = KALMAN_DEFAULT_Q_RATE;
+
+static struct {
+    bool primed;
+    ktime_t last;
+    s64 x[2];                               // Level (milli-%), rate (milli-% per timer period)
+    s64 p[2][2];                            // Covariance
+    s64 innovation;                         // Last measurement minus prediction, milli-%
+} kalman;
+
+static void kalman_update(const struct monitor_inputs *in)
+{
+    s64 steps, y, s, k0, k1, p00, p01, p11;
+
+    if (!kalman.primed) {
+        kalman.primed = true;
+        kalman.last = in->now;
+        kalman.x[0] = (s64)in->sim_workload * 1000;
+        kalman.x[1] = 0;
+        kalman.p[0][0] = (s64)kalman_r_workload * KALMAN_VAR_SCALE;
+        kalman.p[1][1] = (s64)kalman_r_workload * KALMAN_VAR_SCALE;
+        kalman.p[0][1] = kalman.p[1][0] = 0;
+        return;
+    }
+
+    // Predict: x = F x, P = F P F' + Q with F = [1 n; 0 1] for n elapsed timer periods
+    steps = min_t(s64, div_s64(ktime_ms_delta(in->now, kalman.last) + HRTIMER_INTERVAL_MS / 2,
+                               HRTIMER_INTERVAL_MS), KALMAN_MAX_STEPS);
+    if (steps > 0) {
+        kalman.last = in->now;
+        p00 = kalman.p[0][0] + 2 * steps * kalman.p[0][1] + steps * steps * kalman.p[1][1] +
+              steps * div_s64((s64)kalman_q_level * KALMAN_VAR_SCALE, 1000);
+        p01 = kalman.p[0][1] + steps * kalman.p[1][1];
+        p11 = kalman.p[1][1] + steps * div_s64((s64)kalman_q_rate * KALMAN_VAR_SCALE, 1000);
+        kalman.x[0] += steps * kalman.x[1];
+        kalman.p[0][0] = min(p00, KALMAN_P_MAX);
+        kalman.p[0][1] = kalman.p[1][0] = clamp_t(s64, p01, -KALMAN_P_MAX, KALMAN_P_MAX);
+        kalman.p[1][1] = min(p11, KALMAN_P_MAX);
+    }
+
+    // Update: one scalar measurement of the level (H = [1 0]); R = 0 would trust it completely
+    y = (s64)in->sim_workload * 1000 - kalman.x[0];
+    s = max(kalman.p[0][0] + (s64)kalman_r_workload * KALMAN_VAR_SCALE, 1LL);
+    k0 = div64_s64(kalman.p[0][0] * KALMAN_GAIN_SCALE, s);
+    k1 = div64_s64(kalman.p[1][0] * KALMAN_GAIN_SCALE, s);
+
+    kalman.innovation = y;
+    kalman.x[0] += div_s64(k0 * y, KALMAN_GAIN_SCALE);
+    kalman.x[1] += div_s64(k1 * y, KALMAN_GAIN_SCALE);
+
+    // P = (I - K H) P
+    p00 = kalman.p[0][0] - div_s64(k0 * kalman.p[0][0], KALMAN_GAIN_SCALE);
+    p01 = kalman.p[0][1] - div_s64(k0 * kalman.p[0][1], KALMAN_GAIN_SCALE);
+    p11 = kalman.p[1][1] - div_s64(k1 * kalman.p[0][1], KALMAN_GAIN_SCALE);
+    kalman.p[0][0] = max(p00, 1LL);
+    kalman.p[0][1] = kalman.p[1][0] = p01;
+    kalman.p[1][1] = max(p11, 1LL);
+
+    kalman.x[0] = clamp_t(s64, kalman.x[0], 0, (s64)MAX_WORKLOAD_LEVEL * 1000);
+}
+
+// Decision Stability
+// Noise on 100 ms samples would otherwise flap the factor. Inputs are smoothed (Kalman or EWMA), the step
+// policy does not re-engage a direction until the workload crossed its separate release threshold, and the
+// handler enforces a cooldown between adjustments plus a minimum dwell before reversing direction.
+#define STABILITY_DEFAULT_EWMA_WEIGHT 30        // % weight of the newest sample per timer period (100 = no smoothing)
+#define STABILITY_DEFAULT_HIGH_RELEASE 70       // Scale-up re-arms once the workload drops below this
+#define STABILITY_DEFAULT_LOW_RELEASE 30        // Scale-down re-arms once the workload rises above this
+#define STABILITY_DEFAULT_DWELL_MS 1000         // Hold a factor at least this long before reversing
+#define STABILITY_DEFAULT_COOLDOWN_MS 300       // Minimum time between two adjustments
+
+static unsigned long stability_ewma_weight = STABILITY_DEFAULT_EWMA_WEIGHT;
+static unsigned long stability_high_release = STABILITY_DEFAULT_HIGH_RELEASE;
+static unsigned long stability_low_release = STABILITY_DEFAULT_LOW_RELEASE;
+static unsigned long stability_dwell_ms = STABILITY_DEFAULT_DWELL_MS;
+static unsigned long stability_cooldown_ms = STABILITY_DEFAULT_COOLDOWN_MS;
+
+enum signal_filter {
+    SIGNAL_FILTER_NONE,
+    SIGNAL_FILTER_EWMA,
+    SIGNAL_FILTER_KALMAN,
+};
+
+static const char * const signal_filter_names[] = {
+    [SIGNAL_FILTER_NONE] = "none",
+    [SIGNAL_FILTER_EWMA] = "ewma",
+    [SIGNAL_FILTER_KALMAN] = "kalman",
+};
+
+static enum signal_filter signal_filter = SIGNAL_FILTER_EWMA;       // Applied to the workload (p99 always uses the EWMA)
+static s64 ewma_workload = -1;          // milli-percent, -1 = no sample yet
+static s64 ewma_p99_us = -1;            // milli-us, -1 = no fresh SLO reports
+static ktime_t ewma_last_update;
+static ktime_t last_adjust_time;
+static int last_adjust_dir;             // +1 up, -1 down, 0 none yet
+static unsigned long hysteresis_holds;  // Step runs refused because the band was not released yet
+static unsigned long dwell_suppressed;  // Reversals blocked by the minimum dwell
+static unsigned long cooldown_suppressed;   // Adjustments blocked by the cooldown
+
+// Per-mille weight of a sample that arrives dt_ms after the previous one. ewma_weight applies per timer
+// period, so a user-triggered run right after a timer run barely moves the average and a late one moves
+// it as much as the periods it covers: 1 - (1 - w)^(dt / period), the fractional period interpolated.
+static s64 ewma_weight_for(s64 dt_ms)
+{
+    s64 keep = 1000, periods;
+
+    if (stability_ewma_weight >= 100)
+        return 1000;
+    if (dt_ms <= 0)
+        return 0;
+    for (periods = dt_ms / HRTIMER_INTERVAL_MS; periods > 0 && keep > 0; periods--)
+        keep = div_s64(keep * (100 - (s64)stability_ewma_weight), 100);
+    keep -= div_s64(keep * (s64)stability_ewma_weight * (dt_ms % HRTIMER_INTERVAL_MS), 100 * HRTIMER_INTERVAL_MS);
+    return 1000 - keep;
+}
+
+static void ewma_update(s64 *avg, unsigned long sample, s64 weight)
+{
+    s64 milli = (s64)sample * 1000;
+
+    if (*avg < 0)
+        *avg = milli;
+    else
+        *avg += div_s64((milli - *avg) * weight, 1000);
+}
+
+// Replace the raw workload and p99 with their smoothed values (update = false only reads the averages)
+// Both filters run every time, so switching between them is seamless
+static void stability_smooth_inputs(struct monitor_inputs *in, bool update)
+{
+    if (update) {
+        s64 weight = ewma_weight_for(ktime_ms_delta(in->now, ewma_last_update));
+
+        ewma_last_update = in->now;
+        ewma_update(&ewma_workload, in->workload, weight);
+        kalman_update(in);
+        if (in->slo_p99_us)
+            ewma_update(&ewma_p99_us, in->slo_p99_us, weight);
+        else
+            ewma_p99_us = -1;
+    }
+
+    if (signal_filter == SIGNAL_FILTER_KALMAN && kalman.primed) {
+        in->workload = monitor_effective_workload(in, div_s64(kalman.x[0] + 500, 1000));
+        in->load_rate = kalman.x[1];
+        in->load_stddev = int_sqrt64(kalman.p[0][0]);
+    } else if (signal_filter == SIGNAL_FILTER_EWMA && ewma_workload >= 0) {
+        in->workload = div_s64(ewma_workload + 500, 1000);
+    }
+    if (in->slo_p99_us && ewma_p99_us >= 0)
+        in->slo_p99_us = max(div_s64(ewma_p99_us + 500, 1000), 1LL);
+}
+
+// Returns false (and counts it) when an adjustment from current_rf to new_rf must be held back
+static bool stability_allow(const struct monitor_inputs *in, unsigned long current_rf, unsigned long new_rf)
+{
+    int dir = new_rf > current_rf ? 1 : -1;
+    s64 since_ms = ktime_ms_delta(in->now, last_adjust_time);
+
+    if (!last_adjust_dir)
+        return true;
+    if (dir != last_adjust_dir && since_ms < (s64)stability_dwell_ms) {
+        dwell_suppressed++;
+        return false;
+    }
+    if (since_ms < (s64)stability_cooldown_ms) {
+        cooldown_suppressed++;
+        return false;
+    }
+    return true;
+}
+
+static void stability_record(const struct monitor_inputs *in, unsigned long current_rf, unsigned long new_rf)
+{
+    last_adjust_time = in->now;
+    last_adjust_dir = new_rf > current_rf ? 1 : -1;
+}
+
+// Legacy Step Policy
+// +/-1 per run while the workload stays outside the configured band (80/20 by default). Once it falls back
+// inside, the factor is held and that direction stays latched: crossing the band edge again does not step
+// until the workload has first crossed the release threshold (70/30), so noise around 80 or 20 cannot flap
+// the factor. Each refused step counts as a hysteresis hold.
+// With an SLO target and fresh latency reports, steer on p99 instead (that band has its own gap).
+#define STEP_ENGAGED 2                  // Stepping, the workload has stayed outside the band
+#define STEP_LATCHED 1                  // Back inside the band, not yet released
+
+static int step_engaged;                // +/-STEP_ENGAGED, +/-STEP_LATCHED or 0, positive for scale-up
+
+static void step_policy_reset(const struct monitor_inputs *in)
+{
+    step_engaged = 0;
+}
+
+// The band state is passed in, so a policy falling back to the step rules keeps its own
+static unsigned long step_decide(const struct monitor_inputs *in, int *engaged, unsigned long *holds)
+{
+    bool scale_up, scale_down;
+
+    if (slo_target_p99_us && in->slo_p99_us) {
+        *engaged = 0;
+        scale_up = in->slo_p99_us > slo_target_p99_us;
+        scale_down = in->slo_p99_us < slo_target_p99_us * SLO_RELAX_PCT / 100;
+    } else {
+        scale_up = in->workload > in->high_threshold;
+        scale_down = in->workload < in->low_threshold;
+        if (scale_up || scale_down) {
+            int dir = scale_up ? 1 : -1;
+
+            if (*engaged == dir * STEP_LATCHED) {
+                (*holds)++;
+                return in->resource_factor;
+            }
+            *engaged = dir * STEP_ENGAGED;
+        } else {
+            if (abs(*engaged) == STEP_ENGAGED)
+                *engaged /= STEP_ENGAGED;
+            if ((*engaged > 0 && in->workload < min(stability_high_release, in->high_threshold)) ||
+                (*engaged < 0 && in->workload > max(stability_low_release, in->low_threshold)))
+                *engaged = 0;
+        }
+    }
+
+    if (scale_up && in->resource_factor < in->max_factor)
+        return in->resource_factor + 1;
+    if (scale_down && in->resource_factor > 1)
+        return in->resource_factor - 1;
+    return in->resource_factor;
+}
+
+static unsigned long step_policy_decide(const struct monitor_inputs *in)
+{
+    return step_decide(in, &step_engaged, &hysteresis_holds);
+}
+
+static struct monitor_policy step_policy = {
+    .name = "step",
+    .reset = step_policy_reset,
+    .decide = step_policy_decide,
+};
+
+// PID Controller Policy
+// Drives the workload toward a setpoint. Everything is fixed point: gains are in milli-factor units per
+// percent of error, the controller state in milli-factor units. The integral is clamped to the factor
+// range (anti-windup) and the derivative acts on the measurement so setpoint changes don't kick. With the
+// setpoint fixed d(error)/dt equals d(workload)/dt, so a rising workload adds to the output like the error does.
+#define PID_SCALE 1000
+#define PID_DEFAULT_SETPOINT 50     // % workload
+#define PID_DEFAULT_KP 50           // +0.05 factor per % above the setpoint
+#define PID_DEFAULT_KI 20           // +0.02 factor per %-second of accumulated error
+#define PID_DEFAULT_KD 10           // +0.01 factor per %/s of rising workload
+
+static unsigned long pid_setpoint = PID_DEFAULT_SETPOINT;
+static unsigned long pid_kp = PID_DEFAULT_KP;
+static unsigned long pid_ki = PID_DEFAULT_KI;
+static unsigned long pid_kd = PID_DEFAULT_KD;
+
+static s64 pid_integral;                // milli-factor
+static long pid_last_workload;
+static ktime_t pid_last_time;
+static s64 pid_output;                  // milli-factor, before rounding
+
+static void pid_policy_reset(const struct monitor_inputs *in)
+{
+    // Bumpless transfer: start from the current factor with no accumulated error
+    pid_integral = (s64)in->resource_factor * PID_SCALE;
+    pid_output = pid_integral;
+    pid_last_workload = in->workload;
+    pid_last_time = in->now;
+}
+
+static unsigned long pid_policy_decide(const struct monitor_inputs *in)
+{
+    s64 dt_ms = ktime_ms_delta(in->now, pid_last_time);
+    long error = (long)in->workload - (long)pid_setpoint;
+    s64 p_term, d_term = 0, output;
+
+    // User-triggered runs can come back to back, nothing meaningful to integrate
+    if (dt_ms <= 0)
+        return in->resource_factor;
+
+    // The factor was set from Sysfs or held back by the steal guard, re-seed instead of winding up. A
+    // dwell/cooldown deferral keeps the integral, the request applies once the hold expires.
+    if (in->last_outcome == MONITOR_OUTCOME_OVERRIDDEN)
+        pid_integral = (s64)in->resource_factor * PID_SCALE;
+
+    p_term = (s64)pid_kp * error;
+    pid_integral += div_s64((s64)pid_ki * error * dt_ms, MSEC_PER_SEC);
+    pid_integral = clamp_t(s64, pid_integral, PID_SCALE, (s64)in->max_factor * PID_SCALE);
+    // A user-triggered run right after a timer run would turn a small change into a huge slope, so the
+    // slope is never taken over less than one timer period
+    d_term = div_s64((s64)pid_kd * ((long)in->workload - pid_last_workload) * MSEC_PER_SEC,
+                     max_t(s64, dt_ms, HRTIMER_INTERVAL_MS));
+
+    output = clamp_t(s64, p_term + pid_integral + d_term, PID_SCALE, (s64)in->max_factor * PID_SCALE);
+    pid_output = output;
+    pid_last_workload = in->workload;
+    pid_last_time = in->now;
+
+    // Round to the nearest whole resource unit
+    return div_s64(output + PID_SCALE / 2, PID_SCALE);
+}
+
+static int pid_policy_stats(char *buf, size_t size)
+{
+    // Un-rounded controller output and integral term, in milli-factor
+    return scnprintf(buf, size, "output %lld\nintegral %lld\n", pid_output, pid_integral);
+}
+
+static struct monitor_policy pid_policy = {
+    .name = "pid",
+    .reset = pid_policy_reset,
+    .decide = pid_policy_decide,
+    .stats = pid_policy_stats,
+};
+
+// Forecasting Policy
+// Additive Holt-Winters (level, trend, one season) over the raw workload, in milli-percent fixed point.
+// It scales up when the workload predicted forecast_horizon_ms ahead crosses the high threshold, and scales
+// down only when both the current and the predicted workload are below the low threshold. Every forecast is
+// kept until its target sample arrives, so the error is measured against what actually happened.
+#define FORECAST_SCALE 1000
+#define FORECAST_MAX_SEASON 600             // Samples (one minute at the 100 ms timer)
+#define FORECAST_MAX_HORIZON 100            // Samples (ten seconds)
+#define FORECAST_DEFAULT_HORIZON_MS 2000
+#define FORECAST_DEFAULT_SEASON 100         // Samples
+#define FORECAST_DEFAULT_ALPHA 30           // % level smoothing
+#define FORECAST_DEFAULT_BETA 10            // % trend smoothing
+#define FORECAST_DEFAULT_GAMMA 10           // % seasonal smoothing
+#define FORECAST_ERROR_WEIGHT 5             // % EWMA weight of the newest error sample
+
+static unsigned long forecast_horizon_ms = FORECAST_DEFAULT_HORIZON_MS;
+static unsigned long forecast_season = FORECAST_DEFAULT_SEASON;
+static unsigned long forecast_alpha = FORECAST_DEFAULT_ALPHA;
+static unsigned long forecast_beta = FORECAST_DEFAULT_BETA;
+static unsigned long forecast_gamma = FORECAST_DEFAULT_GAMMA;
+
+static struct {
+    bool primed;
+    s64 level;                              // milli-percent
+    s64 trend;                              // milli-percent per sample
+    s64 seasonal[FORECAST_MAX_SEASON];      // milli-percent offset per season slot
+    unsigned long season_len;               // forecast_season the state was built with
+    u64 samples;                            // Samples observed (index of the next one)
+    ktime_t last_sample;
+    s64 predicted;                          // Latest forecast for the horizon, milli-percent (clamped 0-100%)
+    struct {
+        u64 target;                         // Sample index the forecast is for, plus one (0 = empty)
+        s64 value;
+    } pending[FORECAST_MAX_HORIZON];
+    s64 mae;                                // EWMA of |forecast - actual|, milli-percent
+    s64 bias;                               // EWMA of (forecast - actual), milli-percent
+    u64 scored;                             // Forecasts compared against actual samples
+} forecast;
+
+static unsigned long forecast_horizon_samples(void)
+{
+    return clamp_t(unsigned long, DIV_ROUND_UP(forecast_horizon_ms, HRTIMER_INTERVAL_MS), 1, FORECAST_MAX_HORIZON - 1);
+}
+
+static s64 forecast_weigh(s64 newest, s64 previous, unsigned long pct)
+{
+    return previous + div_s64((newest - previous) * (s64)pct, 100);
+}
+
+static void forecast_policy_observe(const struct monitor_inputs *in)
+{
+    s64 x = (s64)in->raw_workload * FORECAST_SCALE;
+    unsigned long h = forecast_horizon_samples();
+    unsigned long slot;
+    u64 target;
+    s64 prev_level, err;
+
+    // One model step per timer period, user-triggered runs in between are ignored
+    if (forecast.primed && ktime_ms_delta(in->now, forecast.last_sample) < HRTIMER_INTERVAL_MS / 2)
+        return;
+
+    // (Re)start on the first sample or when the season length was changed
+    if (!forecast.primed || forecast.season_len != forecast_season) {
+        memset(&forecast, 0, sizeof(forecast));
+        forecast.primed = true;
+        forecast.season_len = forecast_season;
+        forecast.level = x;
+    }
+    forecast.last_sample = in->now;
+
+    // Score the forecast that targeted this sample (the slot may be empty or stale after a horizon change)
+    if (forecast.pending[forecast.samples % FORECAST_MAX_HORIZON].target == forecast.samples + 1) {
+        err = forecast.pending[forecast.samples % FORECAST_MAX_HORIZON].value - x;
+        forecast.mae = forecast.scored ? forecast_weigh(abs(err), forecast.mae, FORECAST_ERROR_WEIGHT) : abs(err);
+        forecast.bias = forecast.scored ? forecast_weigh(err, forecast.bias, FORECAST_ERROR_WEIGHT) : err;
+        forecast.scored++;
+    }
+
+    // Holt-Winters update
+    slot = forecast.samples % forecast.season_len;
+    prev_level = forecast.level;
+    forecast.level = forecast_weigh(x - forecast.seasonal[slot], forecast.level + forecast.trend, forecast_alpha);
+    forecast.trend = forecast_weigh(forecast.level - prev_level, forecast.trend, forecast_beta);
+    forecast.seasonal[slot] = forecast_weigh(x - forecast.level, forecast.seasonal[slot], forecast_gamma);
+    forecast.samples++;
+
+    // Forecast sample (samples - 1 + h), using the seasonal slot of that sample, and remember it for scoring
+    target = forecast.samples - 1 + h;
+    forecast.predicted = clamp_t(s64, forecast.level + (s64)h * forecast.trend +
+                                 forecast.seasonal[target % forecast.season_len],
+                                 0, (s64)MAX_WORKLOAD_LEVEL * FORECAST_SCALE);
+    forecast.pending[target % FORECAST_MAX_HORIZON].target = target + 1;
+    forecast.pending[target % FORECAST_MAX_HORIZON].value = forecast.predicted;
+}
+
+static unsigned long forecast_policy_decide(const struct monitor_inputs *in)
+{
+    unsigned long predicted = div_s64(forecast.predicted + FORECAST_SCALE / 2, FORECAST_SCALE);
+
+    if (!forecast.primed)
+        return in->resource_factor;
+    if (max(predicted, in->workload) > in->high_threshold && in->resource_factor < in->max_factor)
+        return in->resource_factor + 1;
+    if (max(predicted, in->workload) < in->low_threshold && in->resource_factor > 1)
+        return in->resource_factor - 1;
+    return in->resource_factor;
+}
+
+static int forecast_policy_stats(char *buf, size_t size)
+{
+    // Fixed-point internals are printed in milli-percent
+    return scnprintf(buf, size, "samples %llu\nlevel %lld\ntrend %lld\npredicted %lld\nhorizon_samples %lu\n"
+                     "scored %llu\nmae %lld\nbias %lld\n",
+                     forecast.samples, forecast.level, forecast.trend, forecast.predicted, forecast_horizon_samples(),
+                     forecast.scored, forecast.mae, forecast.bias);
+}
+
+static struct monitor_policy forecast_policy = {
+    .name = "forecast",
+    .observe = forecast_policy_observe,
+    .decide = forecast_policy_decide,
+    .stats = forecast_policy_stats,
+};
+
+// Model-Predictive Policy
+// Each run simulates one candidate trajectory per reachable factor (ramp to it one step per run, then
+// hold) over mpc_horizon runs, using a learned linear plant model: how much the workload and the
+// temperature move per unit of factor change, plus the forecaster's trend as the external drift.
+// Trajectories that break the hard workload/temperature limits are only chosen when nothing else fits;
+// among the rest the cheapest one wins and its first move is applied.
+#define MPC_SCALE 1000
+#define MPC_MAX_HORIZON 10
+#define MPC_DEFAULT_HORIZON 5               // Runs
+#define MPC_DEFAULT_COST_RESOURCE 10        // Per factor unit per run
+#define MPC_DEFAULT_COST_MOVE 5             // Per factor change
+#define MPC_DEFAULT_COST_SLO 1              // Per %^2 of workload above mpc_workload_target per run
+#define MPC_DEFAULT_WORKLOAD_TARGET 70      // %
+#define MPC_DEFAULT_WORKLOAD_MAX 90         // % hard limit
+#define MPC_DEFAULT_TEMP_MAX 85             // Degrees Celsius hard limit
+#define MPC_PRIOR_GAIN_WORKLOAD (-5 * MPC_SCALE)    // milli-% of workload per factor unit
+#define MPC_PRIOR_GAIN_TEMP (1 * MPC_SCALE)         // milli-degrees per factor unit
+#define MPC_GAIN_WORKLOAD_MIN (-30 * MPC_SCALE)     // More resources lower the workload, by 1-30% per unit
+#define MPC_GAIN_WORKLOAD_MAX (-1 * MPC_SCALE)
+#define MPC_GAIN_TEMP_MAX (10 * MPC_SCALE)          // ... and never cool the part
+#define MPC_LEARN_WEIGHT 20                 // % EWMA weight of each observed response
+#define MPC_INFEASIBLE_COST 1000000LL       // Per unit (% or degree) over a hard limit
+
+static unsigned long mpc_horizon = MPC_DEFAULT_HORIZON;
+static unsigned long mpc_cost_resource = MPC_DEFAULT_COST_RESOURCE;
+static unsigned long mpc_cost_move = MPC_DEFAULT_COST_MOVE;
+static unsigned long mpc_cost_slo = MPC_DEFAULT_COST_SLO;
+static unsigned long mpc_workload_target = MPC_DEFAULT_WORKLOAD_TARGET;
+static unsigned long mpc_workload_max = MPC_DEFAULT_WORKLOAD_MAX;
+static unsigned long mpc_temp_max = MPC_DEFAULT_TEMP_MAX;
+
+static struct {
+    s64 gain_workload;                      // Learned plant model, milli-units per factor unit
+    s64 gain_temp;
+    u64 updates;                            // Factor changes the model has learned from
+    bool have_last;
+    unsigned long last_factor;
+    unsigned long last_workload;
+    unsigned long last_temp;
+    unsigned long chosen_target;            // Result of the last decision
+    s64 chosen_cost;
+    bool chosen_feasible;
+} mpc = {
+    .gain_workload = MPC_PRIOR_GAIN_WORKLOAD,
+    .gain_temp = MPC_PRIOR_GAIN_TEMP,
+};
+
+static void mpc_policy_observe(const struct monitor_inputs *in)
+{
+    long d = (long)in->resource_factor - (long)mpc.last_factor;
+
+    // Learn from the response to the previous run's factor change
+    if (mpc.have_last && d) {
+        s64 dw = div_s64(((s64)in->raw_workload - (s64)mpc.last_workload) * MPC_SCALE, d);
+        s64 dt = div_s64(((s64)in->gpu_temp - (s64)mpc.last_temp) * MPC_SCALE, d);
+
+        mpc.gain_workload += div_s64((dw - mpc.gain_workload) * MPC_LEARN_WEIGHT, 100);
+        mpc.gain_workload = clamp_t(s64, mpc.gain_workload, MPC_GAIN_WORKLOAD_MIN, MPC_GAIN_WORKLOAD_MAX);
+        mpc.gain_temp += div_s64((dt - mpc.gain_temp) * MPC_LEARN_WEIGHT, 100);
+        mpc.gain_temp = clamp_t(s64, mpc.gain_temp, 0, MPC_GAIN_TEMP_MAX);
+        mpc.updates++;
+    }
+
+    mpc.have_last = true;
+    mpc.last_factor = in->resource_factor;
+    mpc.last_workload = in->raw_workload;
+    mpc.last_temp = in->gpu_temp;
+}
+
+// Cost of ramping from the current factor to target, or a large penalty if a hard limit is broken
+static s64 mpc_trajectory_cost(const struct monitor_inputs *in, unsigned long target, bool *feasible)
+{
+    s64 w = (s64)in->workload * MPC_SCALE;
+    s64 t = (s64)in->gpu_temp * MPC_SCALE;
+    s64 drift = forecast.primed ? forecast.trend : 0;
+    s64 cost = 0, over;
+    unsigned long f = in->resource_factor, k;
+    long move;
+
+    *feasible = true;
+    for (k = 0; k < mpc_horizon; k++) {
+        move = f < target ? 1 : (f > target ? -1 : 0);
+        f += move;
+        w = clamp_t(s64, w + move * mpc.gain_workload + drift, 0, (s64)MAX_WORKLOAD_LEVEL * MPC_SCALE);
+        t += move * mpc.gain_temp;
+
+        cost += (s64)mpc_cost_resource * f + (s64)mpc_cost_move * abs(move);
+        over = div_s64(w, MPC_SCALE) - (s64)mpc_workload_target;
+        if (over > 0)
+            cost += (s64)mpc_cost_slo * over * over;
+
+        over = div_s64(w, MPC_SCALE) - (s64)mpc_workload_max;
+        if (over > 0) {
+            cost += MPC_INFEASIBLE_COST * over;
+            *feasible = false;
+        }
+        over = div_s64(t, MPC_SCALE) - (s64)mpc_temp_max;
+        if (over > 0) {
+            cost += MPC_INFEASIBLE_COST * over;
+            *feasible = false;
+        }
+    }
+    return cost;
+}
+
+static unsigned long mpc_policy_decide(const struct monitor_inputs *in)
+{
+    unsigned long target, best = in->resource_factor;
+    s64 cost, best_cost = S64_MAX;
+    bool feasible, best_feasible = false;
+
+    for (target = 1; target <= in->max_factor; target++) {
+        cost = mpc_trajectory_cost(in, target, &feasible);
+        // Penalties already rank infeasible trajectories last, the flag only feeds the stats
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = target;
+            best_feasible = feasible;
+        }
+    }
+
+    mpc.chosen_target = best;
+    mpc.chosen_cost = best_cost;
+    mpc.chosen_feasible = best_feasible;
+
+    // Apply only the first move of the chosen trajectory
+    if (best > in->resource_factor)
+        return in->resource_factor + 1;
+    if (best < in->resource_factor)
+        return in->resource_factor - 1;
+    return in->resource_factor;
+}
+
+static int mpc_policy_stats(char *buf, size_t size)
+{
+    // Gains are milli-% (workload) and milli-degrees (temperature) per factor unit
+    return scnprintf(buf, size, "gain_workload %lld\ngain_temp %lld\nupdates %llu\ntarget %lu\ncost %lld\nfeasible %d\n",
+                     mpc.gain_workload, mpc.gain_temp, mpc.updates, mpc.chosen_target, mpc.chosen_cost,
+                     mpc.chosen_feasible);
+}
+
+static struct monitor_policy mpc_policy = {
+    .name = "mpc",
+    .observe = mpc_policy_observe,
+    .decide = mpc_policy_decide,
+    .stats = mpc_policy_stats,
+};
+
+// Weighted Multi-Objective Policy
+// Scores the workload, temperature and memory pressure together instead of the workload alone. Temperature
+// and memory are expressed as % of the way to their hard limit (temperature from the 50 degree idle point),
+// and the score is their weighted average, stepped on the configured band like the legacy policy. The hard
+// limits override the score: at or above either one the factor backs off, and within weighted_margin of
+// one (degrees or %) it is never raised, so the adjuster can't scale into a thermal or memory wall.
+// The default limits sit above what the simulation reaches (100 degrees and 66% at full load), so the
+// score's band stays reachable and the limits act as a safety net; lower weighted_temp_max to exercise them.
+#define WEIGHTED_SCALE 1000
+#define WEIGHTED_TEMP_IDLE 50               // Degrees Celsius at zero load (the simulation's calibration)
+#define WEIGHTED_DEFAULT_WORKLOAD 60        // Relative weights, any scale
+#define WEIGHTED_DEFAULT_TEMP 25
+#define WEIGHTED_DEFAULT_MEMORY 15
+#define WEIGHTED_DEFAULT_TEMP_MAX 105       // Degrees Celsius hard limit
+#define WEIGHTED_DEFAULT_MEMORY_MAX 90      // % hard limit
+#define WEIGHTED_DEFAULT_MARGIN 5           // Degrees / % below a limit where scaling up stops
+
+static unsigned long weighted_workload = WEIGHTED_DEFAULT_WORKLOAD;
+static unsigned long weighted_temp = WEIGHTED_DEFAULT_TEMP;
+static unsigned long weighted_memory = WEIGHTED_DEFAULT_MEMORY;
+static unsigned long weighted_temp_max = WEIGHTED_DEFAULT_TEMP_MAX;
+static unsigned long weighted_memory_max = WEIGHTED_DEFAULT_MEMORY_MAX;
+static unsigned long weighted_margin = WEIGHTED_DEFAULT_MARGIN;
+
+static struct {
+    unsigned long score;                    // Last weighted score, milli-percent
+    unsigned long temp_pct;                 // Last normalized temperature and memory pressure, %
+    unsigned long memory_pct;
+    const char *limit;                      // Hard limit that decided the last run, or "none"
+    unsigned long limit_backoffs;           // Runs that backed off because a limit was reached
+    unsigned long limit_holds;              // Scale-ups withheld near a limit
+} weighted = {
+    .limit = "none",
+};
+
+// Share of the way from idle to the limit, 0-100%
+static unsigned long weighted_normalize(unsigned long value, unsigned long idle, unsigned long limit)
+{
+    if (value <= idle)
+        return 0;
+    if (value >= limit)
+        return MAX_WORKLOAD_LEVEL;
+    return (value - idle) * MAX_WORKLOAD_LEVEL / (limit - idle);
+}
+
+static unsigned long weighted_policy_decide(const struct monitor_inputs *in)
+{
+    unsigned long total = weighted_workload + weighted_temp + weighted_memory;
+    bool near_limit;
+
+    weighted.temp_pct = weighted_normalize(in->gpu_temp, WEIGHTED_TEMP_IDLE, weighted_temp_max);
+    weighted.memory_pct = weighted_normalize(in->memory_pressure, 0, weighted_memory_max);
+    // All weights zero: fall back to the workload alone
+    if (total)
+        weighted.score = (weighted_workload * in->workload + weighted_temp * weighted.temp_pct +
+                          weighted_memory * weighted.memory_pct) * WEIGHTED_SCALE / total;
+    else
+        weighted.score = in->workload * WEIGHTED_SCALE;
+
+    // The temperature and memory inputs are unsmoothed, so a limit is seen on the sample that crosses it
+    if (in->gpu_temp >= weighted_temp_max || in->memory_pressure >= weighted_memory_max) {
+        weighted.limit = in->gpu_temp >= weighted_temp_max ? "temperature" : "memory";
+        weighted.limit_backoffs++;
+        return in->resource_factor > 1 ? in->resource_factor - 1 : in->resource_factor;
+    }
+    near_limit = in->gpu_temp + weighted_margin >= weighted_temp_max ||
+                 in->memory_pressure + weighted_margin >= weighted_memory_max;
+    weighted.limit = "none";
+
+    if (weighted.score > in->high_threshold * WEIGHTED_SCALE && in->resource_factor < in->max_factor) {
+        if (!near_limit)
+            return in->resource_factor + 1;
+        weighted.limit = in->gpu_temp + weighted_margin >= weighted_temp_max ? "temperature" : "memory";
+        weighted.limit_holds++;
+        return in->resource_factor;
+    }
+    if (weighted.score < in->low_threshold * WEIGHTED_SCALE && in->resource_factor > 1)
+        return in->resource_factor - 1;
+    return in->resource_factor;
+}
+
+static int weighted_policy_stats(char *buf, size_t size)
+{
+    // Score in milli-percent, normalized temperature/memory in % of the way to their limits
+    return scnprintf(buf, size, "score %lu\ntemp_pct %lu\nmemory_pct %lu\nlimit %s\nlimit_backoffs %lu\nlimit_holds %lu\n",
+                     weighted.score, weighted.temp_pct, weighted.memory_pct, weighted.limit,
+                     weighted.limit_backoffs, weighted.limit_holds);
+}
+
+static struct monitor_policy weighted_policy = {
+    .name = "weighted",
+    .decide = weighted_policy_decide,
+    .stats = weighted_policy_stats,
+};
+
+// Regime Policy
+// Classifies the recent workload into idle, steady, bursty or ramping over a sliding window of raw samples
+// (one per timer period) and steps on that regime's own band and step size. Per window it computes the
+// mean, a least-squares trend, the spread around that trend (so a clean ramp is not mistaken for noise)
+// and the number of sudden upward jumps. A new label must hold for regime_confirm samples before it
+// replaces the current regime. The classifier runs every sample whichever policy is active.
+#define REGIME_WINDOW 100                   // Samples (ten seconds)
+#define REGIME_MIN_SAMPLES 20               // Samples before the first classification
+#define REGIME_LOG_LEN 16
+#define REGIME_DEFAULT_IDLE_MAX 20          // % mean workload
+#define REGIME_DEFAULT_RAMP_DELTA 20        // % change across the window along the trend
+#define REGIME_DEFAULT_BURST_DELTA 15       // % rise between consecutive samples
+#define REGIME_DEFAULT_BURST_COUNT 2        // Bursts per window
+#define REGIME_DEFAULT_NOISE 10             // % spread around the trend
+#define REGIME_DEFAULT_CONFIRM 10           // Samples
+
+enum monitor_regime {
+    REGIME_IDLE,
+    REGIME_STEADY,
+    REGIME_BURSTY,
+    REGIME_RAMPING,
+    REGIME_COUNT,
+};
+
+static const char * const regime_names[] = { "idle", "steady", "bursty", "ramping" };
+
+// Bursty loads scale up early and give resources back late, idle ones release early
+static struct regime_params {
+    unsigned long high;                     // Scale up above this workload (%)
+    unsigned long low;                      // Scale down below this workload (%)
+    unsigned long step;                     // Factor units per adjustment
+} regime_params[REGIME_COUNT] = {
+    [REGIME_IDLE] = { .high = 80, .low = 30, .step = 1 },
+    [REGIME_STEADY] = { .high = DEFAULT_WORKLOAD_HIGH_THRESHOLD, .low = DEFAULT_WORKLOAD_LOW_THRESHOLD, .step = 1 },
+    [REGIME_BURSTY] = { .high = 65, .low = 15, .step = 2 },
+    [REGIME_RAMPING] = { .high = 70, .low = 25, .step = 1 },
+};
+
+static unsigned long regime_idle_max = REGIME_DEFAULT_IDLE_MAX;
+static unsigned long regime_ramp_delta = REGIME_DEFAULT_RAMP_DELTA;
+static unsigned long regime_burst_delta = REGIME_DEFAULT_BURST_DELTA;
+static unsigned long regime_burst_count = REGIME_DEFAULT_BURST_COUNT;
+static unsigned long regime_noise = REGIME_DEFAULT_NOISE;
+static unsigned long regime_confirm = REGIME_DEFAULT_CONFIRM;
+
+struct regime_transition {
+    ktime_t time;
+    u8 from, to;
+    s64 mean;                               // Window features at the transition, milli-percent
+    s64 noise;
+    s64 change;
+    unsigned int bursts;
+};
+
+static struct {
+    unsigned long samples[REGIME_WINDOW];   // Ring of raw workload samples, oldest at head once full
+    unsigned int head, count;
+    ktime_t last_sample;
+    enum monitor_regime regime;
+    enum monitor_regime candidate;          // Latest label and how many samples in a row it was seen
+    unsigned long candidate_runs;
+    ktime_t since;                          // When the current regime was entered
+    s64 mean, noise, change;                // Latest window features, milli-percent
+    unsigned int bursts;
+    u64 transitions;
+    u64 time_ms[REGIME_COUNT];              // Time spent in each regime
+    struct regime_transition log[REGIME_LOG_LEN];   // Ring, newest at (log_head - 1)
+    unsigned int log_head;
+} regime = {
+    .regime = REGIME_STEADY,
+    .candidate = REGIME_STEADY,
+};
+
+static unsigned long regime_sample(unsigned int i)
+{
+    return regime.samples[(regime.head + REGIME_WINDOW - regime.count + i) % REGIME_WINDOW];
+}
+
+// Compute the window features and return the label they point to
+static enum monitor_regime regime_classify(void)
+{
+    s64 n = regime.count, sum = 0, sxy = 0, sxx = 0, slope, dev, var = 0, c, x;
+    unsigned int i;
+
+    regime.bursts = 0;
+    for (i = 0; i < n; i++) {
+        // Centered index doubled, so it stays integral for an even window
+        c = 2 * (s64)i - (n - 1);
+        x = (s64)regime_sample(i) * 1000;
+        sum += x;
+        sxy += c * x;
+        sxx += c * c;
+        if (i && regime_sample(i) >= regime_sample(i - 1) + regime_burst_delta)
+            regime.bursts++;
+    }
+    regime.mean = div64_s64(sum, n);
+    slope = div64_s64(2 * sxy, sxx);        // milli-percent per sample
+    regime.change = slope * (n - 1);
+
+    for (i = 0; i < n; i++) {
+        c = 2 * (s64)i - (n - 1);
+        dev = (s64)regime_sample(i) * 1000 - regime.mean - div_s64(slope * c, 2);
+        var += dev * dev;
+    }
+    regime.noise = int_sqrt64(div64_s64(var, n));
+
+    if (regime.bursts >= regime_burst_count || regime.noise >= (s64)regime_noise * 1000)
+        return REGIME_BURSTY;
+    if (abs(regime.change) >= (s64)regime_ramp_delta * 1000)
+        return REGIME_RAMPING;
+    if (regime.mean <= (s64)regime_idle_max * 1000)
+        return REGIME_IDLE;
+    return REGIME_STEADY;
+}
+
+static void regime_policy_observe(const struct monitor_inputs *in)
+{
+    struct regime_transition *t;
+    enum monitor_regime label;
+
+    // One sample per timer period, user-triggered runs in between are ignored
+    if (regime.count && ktime_ms_delta(in->now, regime.last_sample) < HRTIMER_INTERVAL_MS / 2)
+        return;
+    if (regime.count)
+        regime.time_ms[regime.regime] += ktime_ms_delta(in->now, regime.last_sample);
+    else
+        regime.since = in->now;
+    regime.last_sample = in->now;
+
+    regime.samples[regime.head] = in->raw_workload;
+    regime.head = (regime.head + 1) % REGIME_WINDOW;
+    regime.count = min(regime.count + 1, (unsigned int)REGIME_WINDOW);
+    if (regime.count < REGIME_MIN_SAMPLES)
+        return;
+
+    label = regime_classify();
+    if (label != regime.candidate) {
+        regime.candidate = label;
+        regime.candidate_runs = 0;
+    }
+    if (label == regime.regime || ++regime.candidate_runs < regime_confirm)
+        return;
+
+    t = &regime.log[regime.log_head];
+    t->time = in->now;
+    t->from = regime.regime;
+    t->to = label;
+    t->mean = regime.mean;
+    t->noise = regime.noise;
+    t->change = regime.change;
+    t->bursts = regime.bursts;
+    regime.log_head = (regime.log_head + 1) % REGIME_LOG_LEN;
+    regime.transitions++;
+
+    printk(KERN_INFO "%s: Workload regime %s -> %s\n", DEVICE_NAME, regime_names[regime.regime], regime_names[label]);
+    regime.regime = label;
+    regime.since = in->now;
+}
+
+static unsigned long regime_policy_decide(const struct monitor_inputs *in)
+{
+    const struct regime_params *p = &regime_params[regime.regime];
+
+    if (in->workload > p->high)
+        return min(in->resource_factor + p->step, in->max_factor);
+    if (in->workload < p->low)
+        return in->resource_factor > p->step ? in->resource_factor - p->step : 1;
+    return in->resource_factor;
+}
+
+static int regime_policy_stats(char *buf, size_t size)
+{
+    struct regime_transition *t;
+    unsigned int i, n;
+    int len;
+
+    // Window features in milli-percent: mean, spread around the trend, change along the trend
+    len = scnprintf(buf, size, "regime %s\nsince_ms %lld\ntransitions %llu\nsamples %u\nmean %lld\nnoise %lld\n"
+                    "change %lld\nbursts %u\n",
+                    regime_names[regime.regime], regime.count ? ktime_ms_delta(ktime_get(), regime.since) : 0,
+                    regime.transitions, regime.count, regime.mean, regime.noise, regime.change, regime.bursts);
+    for (i = 0; i < REGIME_COUNT; i++)
+        len += scnprintf(buf + len, size - len, "time_ms_%s %llu\n", regime_names[i], regime.time_ms[i]);
+
+    // Recent transitions, oldest first
+    n = min_t(u64, regime.transitions, REGIME_LOG_LEN);
+    len += scnprintf(buf + len, size - len, "time_ms from to mean noise change bursts\n");
+    for (i = 0; i < n; i++) {
+        t = &regime.log[(regime.log_head + REGIME_LOG_LEN - n + i) % REGIME_LOG_LEN];
+        len += scnprintf(buf + len, size - len, "%lld %s %s %lld %lld %lld %u\n", ktime_to_ms(t->time),
+                         regime_names[t->from], regime_names[t->to], t->mean, t->noise, t->change, t->bursts);
+    }
+    return len;
+}
+
+static struct monitor_policy regime_policy = {
+    .name = "regime",
+    .observe = regime_policy_observe,
+    .decide = regime_policy_decide,
+    .stats = regime_policy_stats,
+};
+
+// Learning Policy
+// Treats every factor level as an arm of a multi-armed bandit. The factor in effect is held for
+// bandit_epoch_ms while its reward is averaged, then the arm's estimate is updated and the next arm picked:
+// with probability bandit_explore_pct a random neighbour, otherwise one step toward the best known arm
+// (untried neighbours first, so it hill-climbs from wherever it starts). Rewards are per resource unit:
+//   utilization - workload %, or a penalty once above the high threshold (saturated)
+//   throughput  - requests/s summed over fresh SLO reporters
+//   slo         - 1 while the p99 target is met (needs target_p99_us and fresh reports), 0 otherwise
+#define BANDIT_DEFAULT_EPOCH_MS 2000
+#define BANDIT_DEFAULT_EXPLORE_PCT 10
+#define BANDIT_MIN_WEIGHT 10                // % floor on the update weight so old estimates keep adapting
+
+enum bandit_reward_source {
+    BANDIT_REWARD_UTILIZATION,
+    BANDIT_REWARD_THROUGHPUT,
+    BANDIT_REWARD_SLO,
+};
+
+static const char * const bandit_reward_names[] = {
+    [BANDIT_REWARD_UTILIZATION] = "utilization",
+    [BANDIT_REWARD_THROUGHPUT] = "throughput",
+    [BANDIT_REWARD_SLO] = "slo",
+};
+
+static unsigned long bandit_epoch_ms = BANDIT_DEFAULT_EPOCH_MS;
+static unsigned long bandit_explore_pct = BANDIT_DEFAULT_EXPLORE_PCT;
+static enum bandit_reward_source bandit_reward = BANDIT_REWARD_UTILIZATION;
+
+static struct bandit_arm {
+    u64 pulls;                              // Completed epochs at this factor
+    s64 mean;                               // Estimated reward, milli-units
+    s64 last;                               // Reward of the latest epoch
+} bandit_arms[AUTO_MONITOR_FACTOR_LIMIT + 1];   // Indexed by factor, [0] unused
+
+static struct {
+    unsigned long arm;                      // Factor the running epoch measures (0 = none)
+    ktime_t start;
+    s64 reward_sum;
+    u64 reward_samples;
+    u64 explorations;
+} bandit;
+
+static s64 bandit_sample_reward(const struct monitor_inputs *in)
+{
+    s64 goodput;
+
+    switch (bandit_reward) {
+    case BANDIT_REWARD_THROUGHPUT:
+        goodput = (s64)in->slo_throughput * 1000;
+        break;
+    case BANDIT_REWARD_SLO:
+        goodput = (slo_target_p99_us && in->slo_p99_us && in->slo_p99_us <= slo_target_p99_us) ? 1000 : 0;
+        break;
+    default:
+        if (in->workload > in->high_threshold)
+            return -(s64)(in->workload - in->high_threshold) * 1000;
+        goodput = (s64)in->workload * 1000;
+        break;
+    }
+    return div_s64(goodput, in->resource_factor);
+}
+
+static void bandit_policy_reset(const struct monitor_inputs *in)
+{
+    // Keep the learned table, just start a fresh epoch at the current factor
+    bandit.arm = 0;
+}
+
+static unsigned long bandit_next_arm(unsigned long arm, unsigned long max_factor)
+{
+    unsigned long best = arm, f;
+
+    if (get_random_u32() % 100 < bandit_explore_pct) {
+        bandit.explorations++;
+        if (arm >= max_factor)
+            return max(arm - 1, 1UL);
+        if (arm == 1)
+            return 2;
+        return get_random_u32() % 2 ? arm + 1 : arm - 1;
+    }
+
+    // Untried neighbours are worth one epoch each before trusting the table
+    if (arm < max_factor && !bandit_arms[arm + 1].pulls)
+        return arm + 1;
+    if (arm > 1 && !bandit_arms[arm - 1].pulls)
+        return arm - 1;
+
+    for (f = 1; f <= max_factor; f++) {
+        if (bandit_arms[f].pulls && bandit_arms[f].mean > bandit_arms[best].mean)
+            best = f;
+    }
+    return best > arm ? arm + 1 : (best < arm ? arm - 1 : arm);
+}
+
+static unsigned long bandit_policy_decide(const struct monitor_inputs *in)
+{
+    struct bandit_arm *a;
+    s64 reward;
+    u64 weight;
+
+    // The factor can be held back (cooldown, steal) or set from Sysfs; rewards belong to the one in effect
+    if (bandit.arm != in->resource_factor) {
+        bandit.arm = in->resource_factor;
+        bandit.start = in->now;
+        bandit.reward_sum = 0;
+        bandit.reward_samples = 0;
+    }
+
+    bandit.reward_sum += bandit_sample_reward(in);
+    bandit.reward_samples++;
+    if (ktime_ms_delta(in->now, bandit.start) < (s64)bandit_epoch_ms)
+        return in->resource_factor;
+
+    // Epoch complete: sample-average update, with a floor so the estimate tracks a changing workload
+    a = &bandit_arms[bandit.arm];
+    reward = div64_s64(bandit.reward_sum, bandit.reward_samples);
+    a->pulls++;
+    weight = max_t(u64, div64_u64(100, a->pulls), BANDIT_MIN_WEIGHT);
+    a->mean = a->pulls == 1 ? reward : a->mean + div_s64((reward - a->mean) * (s64)weight, 100);
+    a->last = reward;
+
+    bandit.start = in->now;
+    bandit.reward_sum = 0;
+    bandit.reward_samples = 0;
+    return bandit_next_arm(bandit.arm, in->max_factor);
+}
+
+static int bandit_policy_stats(char *buf, size_t size)
+{
+    struct adjust_config cfg;
+    unsigned long f;
+    int len;
+
+    // One row per factor up to the current ceiling, rewards in milli-units per resource unit; '*' marks the
+    // arm being measured
+    adjust_config_get(&cfg);
+    len = scnprintf(buf, size, "factor pulls mean last\n");
+    for (f = 1; f <= cfg.max_factor; f++)
+        len += scnprintf(buf + len, size - len, "%lu%s %llu %lld %lld\n", f, f == bandit.arm ? "*" : "",
+                         bandit_arms[f].pulls, bandit_arms[f].mean, bandit_arms[f].last);
+    len += scnprintf(buf + len, size - len, "explorations %llu\n", bandit.explorations);
+    return len;
+}
+
+static struct monitor_policy bandit_policy = {
+    .name = "bandit",
+    .reset = bandit_policy_reset,
+    .decide = bandit_policy_decide,
+    .stats = bandit_policy_stats,
+};
+
+// Loadable Model Policy
+// Evaluates a decision tree or quantized linear model uploaded with AUTO_MONITOR_IOC_MODEL_LOAD (format in
+// auto_monitor_ioctl.h). Blobs are fully validated before they are published with rcu_replace_pointer(),
+// so the work handler only ever sees a complete, well-formed model; the replaced model is freed with
+// kfree_rcu() after a grace period. Without a model the factor is held.
+#define MODEL_MAX_SIZE (sizeof(struct auto_monitor_model_header) + \
+                        AUTO_MONITOR_MODEL_MAX_NODES * sizeof(struct auto_monitor_model_node))
+#define MODEL_FEATURE_LIMIT (1LL << 27)     // Linear features are clamped so the weighted sum cannot overflow
+
+struct loaded_model {
+    struct rcu_head rcu;
+    unsigned long generation;               // Bumped on every successful load
+    struct auto_monitor_model_header hdr;
+    union {
+        DECLARE_FLEX_ARRAY(struct auto_monitor_model_node, nodes);
+        DECLARE_FLEX_ARRAY(s32, weights);
+    };
+};
+
+static struct loaded_model __rcu *active_model;
+static unsigned long model_generation;
+static unsigned long model_rejected;        // Blobs that failed validation
+static unsigned long model_evaluations;
+static long model_last_output;              // milli-factor
+
+static s64 model_feature(const struct monitor_inputs *in, unsigned int feature)
+{
+    switch (feature) {
+    case AUTO_MONITOR_FEAT_WORKLOAD: return in->workload;
+    case AUTO_MONITOR_FEAT_SIM_WORKLOAD: return in->sim_workload;
+    case AUTO_MONITOR_FEAT_GPU_TEMP: return in->gpu_temp;
+    case AUTO_MONITOR_FEAT_MEMORY_PRESSURE: return in->memory_pressure;
+    case AUTO_MONITOR_FEAT_IO_UTILIZATION: return in->io_utilization;
+    case AUTO_MONITOR_FEAT_NET_UTILIZATION: return in->net_utilization;
+    case AUTO_MONITOR_FEAT_IRQ_LOAD: return in->irq_load;
+    case AUTO_MONITOR_FEAT_STEAL_TIME: return in->steal_time;
+    case AUTO_MONITOR_FEAT_RECLAIM_PRESSURE: return in->reclaim_pressure;
+    case AUTO_MONITOR_FEAT_WATCH_STARVATION: return in->watch_starvation;
+    case AUTO_MONITOR_FEAT_SLO_P99_US: return in->slo_p99_us;
+    case AUTO_MONITOR_FEAT_SLO_THROUGHPUT: return in->slo_throughput;
+    case AUTO_MONITOR_FEAT_LOAD_RATE: return in->load_rate;
+    case AUTO_MONITOR_FEAT_RESOURCE_FACTOR: return in->resource_factor;
+    default: return 0;
+    }
+}
+
+static int model_validate(const struct loaded_model *m, size_t payload)
+{
+    const struct auto_monitor_model_header *hdr = &m->hdr;
+    u32 i;
+
+    if (hdr->magic != AUTO_MONITOR_MODEL_MAGIC || hdr->version != AUTO_MONITOR_MODEL_VERSION)
+        return -EINVAL;
+
+    switch (hdr->kind) {
+    case AUTO_MONITOR_MODEL_TREE:
+        if (!hdr->count || hdr->count > AUTO_MONITOR_MODEL_MAX_NODES ||
+            payload != hdr->count * sizeof(struct auto_monitor_model_node))
+            return -EINVAL;
+        for (i = 0; i < hdr->count; i++) {
+            const struct auto_monitor_model_node *n = &m->nodes[i];
+
+            if (n->feature == AUTO_MONITOR_MODEL_LEAF) {
+                if (n->value < 1 || n->value > AUTO_MONITOR_FACTOR_LIMIT)
+                    return -ERANGE;
+                continue;
+            }
+            // Children strictly after their parent: every walk ends at a leaf within count steps
+            if (n->feature >= AUTO_MONITOR_FEAT_COUNT || n->left <= i || n->right <= i ||
+                n->left >= hdr->count || n->right >= hdr->count)
+                return -EINVAL;
+        }
+        return 0;
+    case AUTO_MONITOR_MODEL_LINEAR:
+        if (!hdr->count || hdr->count > AUTO_MONITOR_FEAT_COUNT || hdr->shift > 31 ||
+            payload != hdr->count * sizeof(s32))
+            return -EINVAL;
+        // The weighted sum stays below 2^62, a bias within the factor range keeps the output from overflowing
+        if (hdr->bias < -(s64)AUTO_MONITOR_FACTOR_LIMIT * 1000 || hdr->bias > (s64)AUTO_MONITOR_FACTOR_LIMIT * 1000)
+            return -ERANGE;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+// Returns the target factor in milli-units (caller holds rcu_read_lock)
+static s64 model_evaluate(const struct loaded_model *m, const struct monitor_inputs *in)
+{
+    const struct auto_monitor_model_node *n;
+    s64 sum = 0;
+    u32 i = 0;
+
+    if (m->hdr.kind == AUTO_MONITOR_MODEL_LINEAR) {
+        for (i = 0; i < m->hdr.count; i++)
+            sum += (s64)m->weights[i] * clamp_t(s64, model_feature(in, i), -MODEL_FEATURE_LIMIT, MODEL_FEATURE_LIMIT);
+        return m->hdr.bias + (sum >> m->hdr.shift);
+    }
+
+    for (n = &m->nodes[0]; n->feature != AUTO_MONITOR_MODEL_LEAF; n = &m->nodes[i])
+        i = model_feature(in, n->feature) <= n->threshold ? n->left : n->right;
+    return (s64)n->value * 1000;
+}
+
+static unsigned long model_policy_decide(const struct monitor_inputs *in)
+{
+    struct loaded_model *m;
+    s64 out;
+
+    rcu_read_lock();
+    m = rcu_dereference(active_model);
+    if (!m) {
+        rcu_read_unlock();
+        return in->resource_factor;
+    }
+    out = model_evaluate(m, in);
+    rcu_read_unlock();
+
+    out = clamp_t(s64, out, 1000, (s64)in->max_factor * 1000);
+    model_evaluations++;
+    model_last_output = out;
+    return div_s64(out + 500, 1000);
+}
+
+static int model_policy_stats(char *buf, size_t size)
+{
+    struct loaded_model *m = rcu_dereference_protected(active_model, lockdep_is_held(&monitor_config_mutex));
+    int len;
+
+    if (m)
+        len = scnprintf(buf, size, "kind %s\nentries %u\ngeneration %lu\n",
+                        m->hdr.kind == AUTO_MONITOR_MODEL_TREE ? "tree" : "linear", m->hdr.count, m->generation);
+    else
+        len = scnprintf(buf, size, "kind none\n");
+    len += scnprintf(buf + len, size - len, "evaluations %lu\nlast_output %ld\nrejected %lu\n",
+                     model_evaluations, model_last_output, model_rejected);
+    return len;
+}
+
+static struct monitor_policy model_policy = {
+    .name = "model",
+    .decide = model_policy_decide,
+    .stats = model_policy_stats,
+};
+
+static long model_ioctl_load(struct auto_monitor_model_load __user *uarg)
+{
+    struct auto_monitor_model_load req;
+    struct loaded_model *m = NULL, *old;
+    size_t payload;
+    int ret;
+
+    // The blob is copied straight over the header and the payload that follows it
+    BUILD_BUG_ON(offsetof(struct loaded_model, nodes) !=
+                 offsetof(struct loaded_model, hdr) + sizeof(struct auto_monitor_model_header));
+
+    if (copy_from_user(&req, uarg, sizeof(req)))
+        return -EFAULT;
+
+    if (req.size) {
+        if (req.size < sizeof(struct auto_monitor_model_header) || req.size > MODEL_MAX_SIZE)
+            return -EINVAL;
+        payload = req.size - sizeof(struct auto_monitor_model_header);
+        m = kzalloc(sizeof(*m) + payload, GFP_KERNEL);
+        if (!m)
+            return -ENOMEM;
+        if (copy_from_user(&m->hdr, u64_to_user_ptr(req.data), req.size)) {
+            kfree(m);
+            return -EFAULT;
+        }
+        ret = model_validate(m, payload);
+        if (ret) {
+            mutex_lock(&monitor_config_mutex);
+            model_rejected++;
+            mutex_unlock(&monitor_config_mutex);
+            kfree(m);
+            return ret;
+        }
+    }
+
+    mutex_lock(&monitor_config_mutex);
+    if (m)
+        m->generation = ++model_generation;
+    old = rcu_replace_pointer(active_model, m, lockdep_is_held(&monitor_config_mutex));
+    mutex_unlock(&monitor_config_mutex);
+    if (old)
+        kfree_rcu(old, rcu);
+
+    if (m)
+        printk(KERN_INFO "%s: Loaded %s model generation %lu (%u entries)\n", DEVICE_NAME,
+               m->hdr.kind == AUTO_MONITOR_MODEL_TREE ? "tree" : "linear", m->generation, m->hdr.count);
+    else
+        printk(KERN_INFO "%s: Model unloaded\n", DEVICE_NAME);
+    return 0;
+}
+
+// BPF Policy
+// Exposes the decision as the "auto_monitor_ops" BPF struct_ops, so a verified BPF program can compute
+// the factor from the same inputs without building a module. Written against the mainline struct_ops API
+// for modules (register_bpf_struct_ops, reg/unreg with a bpf_link). One program can be attached at a
+// time. While none is, or when it returns 0, the step rules decide with a band state of their own, so the
+// fallback never moves the step policy's state or its hysteresis_holds.
+#if defined(CONFIG_BPF_JIT) && defined(CONFIG_BPF_SYSCALL)
+static DEFINE_MUTEX(bpf_ops_mutex);      // Serializes attach/detach
+static struct auto_monitor_ops __rcu *bpf_attached_ops;
+static unsigned long bpf_decisions;
+static unsigned long bpf_fallbacks;
+static int bpf_fallback_engaged;
+static unsigned long bpf_fallback_holds;
+
+static const struct bpf_func_proto *bpf_ops_get_func_proto(enum bpf_func_id func_id, const struct bpf_prog *prog)
+{
+    return bpf_base_func_proto(func_id, prog);
+}
+
+// Programs may read their arguments (and through them the inputs), never write kernel memory
+static bool bpf_ops_is_valid_access(int off, int size, enum bpf_access_type type, const struct bpf_prog *prog,
+                                    struct bpf_insn_access_aux *info)
+{
+    return bpf_tracing_btf_ctx_access(off, size, type, prog, info);
+}
+
+static const struct bpf_verifier_ops bpf_ops_verifier_ops = {
+    .get_func_proto = bpf_ops_get_func_proto,
+    .is_valid_access = bpf_ops_is_valid_access,
+};
+
+static int bpf_ops_init(struct btf *btf)
+{
+    return 0;
+}
+
+static int bpf_ops_check_member(const struct btf_type *t, const struct btf_member *member,
+                                const struct bpf_prog *prog)
+{
+    // decide() runs under rcu_read_lock() with monitor_config_mutex held, so it must not sleep
+    if (prog->sleepable)
+        return -EINVAL;
+    return 0;
+}
+
+static int bpf_ops_init_member(const struct btf_type *t, const struct btf_member *member,
+                               void *kdata, const void *udata)
+{
+    const struct auto_monitor_ops *uops = udata;
+    struct auto_monitor_ops *ops = kdata;
+
+    // Function members are filled in by the core, the name is copied (and checked) here
+    if (__btf_member_bit_offset(t, member) / 8 == offsetof(struct auto_monitor_ops, name)) {
+        if (bpf_obj_name_cpy(ops->name, uops->name, sizeof(ops->name)) <= 0)
+            return -EINVAL;
+        return 1;
+    }
+    return 0;
+}
+
+static int bpf_ops_reg(void *kdata, struct bpf_link *link)
+{
+    struct auto_monitor_ops *ops = kdata;
+    int ret = 0;
+
+    mutex_lock(&bpf_ops_mutex);
+    if (rcu_access_pointer(bpf_attached_ops))
+        ret = -EBUSY;
+    else
+        rcu_assign_pointer(bpf_attached_ops, ops);
+    mutex_unlock(&bpf_ops_mutex);
+
+    if (!ret)
+        printk(KERN_INFO "%s: BPF policy %s attached\n", DEVICE_NAME, ops->name);
+    return ret;
+}
+
+static void bpf_ops_unreg(void *kdata, struct bpf_link *link)
+{
+    mutex_lock(&bpf_ops_mutex);
+    if (rcu_access_pointer(bpf_attached_ops) == kdata)
+        RCU_INIT_POINTER(bpf_attached_ops, NULL);
+    mutex_unlock(&bpf_ops_mutex);
+
+    // The program may be freed once this returns
+    synchronize_rcu();
+    printk(KERN_INFO "%s: BPF policy detached\n", DEVICE_NAME);
+}
+
+static unsigned long bpf_ops_decide_stub(const struct monitor_inputs *in)
+{
+    return 0;
+}
+
+static struct auto_monitor_ops __bpf_ops_auto_monitor_ops = {
+    .decide = bpf_ops_decide_stub,
+};
+
+static struct bpf_struct_ops bpf_auto_monitor_ops = {
+    .verifier_ops = &bpf_ops_verifier_ops,
+    .init = bpf_ops_init,
+    .check_member = bpf_ops_check_member,
+    .init_member = bpf_ops_init_member,
+    .reg = bpf_ops_reg,
+    .unreg = bpf_ops_unreg,
+    .cfi_stubs = &__bpf_ops_auto_monitor_ops,
+    .name = "auto_monitor_ops",
+    .owner = THIS_MODULE,
+};
+
+// The struct_ops type lives as long as the module, the core drops it with the module's BTF. A failure
+// only leaves this policy out, see monitor_policies_init().
+static int bpf_policy_init(void)
+{
+    return register_bpf_struct_ops(&bpf_auto_monitor_ops, auto_monitor_ops);
+}
+
+static void bpf_policy_reset(const struct monitor_inputs *in)
+{
+    bpf_fallback_engaged = 0;
+}
+
+// Called inside the handler's RCU read-side section
+static unsigned long bpf_policy_decide(const struct monitor_inputs *in)
+{
+    struct auto_monitor_ops *ops = rcu_dereference(bpf_attached_ops);
+    unsigned long rf;
+
+    if (ops) {
+        rf = ops->decide(in);
+        if (rf) {
+            bpf_decisions++;
+            return rf;
+        }
+    }
+    bpf_fallbacks++;
+    return step_decide(in, &bpf_fallback_engaged, &bpf_fallback_holds);
+}
+
+static int bpf_policy_stats(char *buf, size_t size)
+{
+    struct auto_monitor_ops *ops;
+    int len;
+
+    rcu_read_lock();
+    ops = rcu_dereference(bpf_attached_ops);
+    len = scnprintf(buf, size, "attached %s\n", ops ? ops->name : "none");
+    rcu_read_unlock();
+    len += scnprintf(buf + len, size - len, "decisions %lu\nfallbacks %lu\nfallback_hysteresis_holds %lu\n",
+                     bpf_decisions, bpf_fallbacks, bpf_fallback_holds);
+    return len;
+}
+
+static struct monitor_policy bpf_policy = {
+    .name = "bpf",
+    .init = bpf_policy_init,
+    .reset = bpf_policy_reset,
+    .decide = bpf_policy_decide,
+    .stats = bpf_policy_stats,
+};
+#endif
+
+static struct monitor_policy *builtin_policies[] = {
+    &step_policy,
+    &pid_policy,
+    &forecast_policy,
+    &mpc_policy,
+    &weighted_policy,
+    &regime_policy,
+    &bandit_policy,
+    &model_policy,
+#if defined(CONFIG_BPF_JIT) && defined(CONFIG_BPF_SYSCALL)
+    &bpf_policy,
+#endif
+};
+
+// Policy Registry
+// Writers (registration, switching) hold policy_registry_mutex. The work handler only reads the list
+// and the active pointer under RCU, so switching never waits for a handler run and vice versa. The
+// handler resets a newly selected policy on its first run, seeing the switch through policy_switch_gen.
+static LIST_HEAD(monitor_policy_list);
+static DEFINE_MUTEX(policy_registry_mutex);
+static struct monitor_policy __rcu *active_policy = &step_policy;
+static unsigned long policy_switch_gen;
+
+// Shadow Policy
+// An optional second policy decides on the same inputs every run without actuating anything. Its
+// would-be decisions are compared with the active policy's (before the steal guard and dwell/cooldown,
+// which would hold both alike). Like any policy it sees the real current factor, not the one it would
+// have set itself.
+#define SHADOW_LOG_LEN 16
+
+struct shadow_decision {
+    ktime_t time;
+    unsigned long workload;
+    unsigned long active_rf;
+    unsigned long shadow_rf;
+};
+
+static struct monitor_policy __rcu *shadow_policy;
+static unsigned long shadow_switch_gen;
+static struct {
+    u64 runs;
+    u64 agreements;
+    u64 shadow_higher;                      // Shadow would have set a larger factor
+    u64 shadow_lower;
+    u64 abs_diff_sum;                       // Sum of |shadow - active| over all runs
+    unsigned long max_abs_diff;
+    struct shadow_decision log[SHADOW_LOG_LEN];     // Ring, newest at (log_head - 1)
+    unsigned int log_head;
+} shadow;
+
+// Caller holds policy_registry_mutex (policy NULL = no shadow)
+static int policy_set_shadow(struct monitor_policy *policy)
+{
+    struct monitor_policy *old = rcu_dereference_protected(shadow_policy, lockdep_is_held(&policy_registry_mutex));
+
+    if (old == policy)
+        return 0;
+    if (policy && !try_module_get(policy->owner))
+        return -ENODEV;
+    rcu_assign_pointer(shadow_policy, policy);
+    WRITE_ONCE(shadow_switch_gen, shadow_switch_gen + 1);
+    if (old)
+        module_put(old->owner);
+    printk(KERN_INFO "%s: Shadow policy set to %s\n", DEVICE_NAME, policy ? policy->name : "none");
+    return 0;
+}
+
+// Called from the work handler (monitor_config_mutex and rcu_read_lock held) with the active decision and
+// the policy_switch_gen the handler saw when it picked the active policy
+static void shadow_evaluate(struct monitor_policy *active, unsigned long active_gen, const struct monitor_inputs *in,
+                            unsigned long active_rf)
+{
+    static unsigned long shadow_seen_gen, active_seen_gen;
+    struct monitor_policy *policy = rcu_dereference(shadow_policy);
+    struct shadow_decision *d;
+    unsigned long shadow_rf, diff;
+
+    // Either side changing starts a new comparison, old statistics would mix two pairs of policies. That
+    // includes the shadow ceasing to be the active policy, whose state the active runs have been advancing.
+    if (READ_ONCE(shadow_switch_gen) != shadow_seen_gen || active_gen != active_seen_gen) {
+        shadow_seen_gen = READ_ONCE(shadow_switch_gen);
+        active_seen_gen = active_gen;
+        memset(&shadow, 0, sizeof(shadow));
+        if (policy && policy != active && policy->reset)
+            policy->reset(in);
+    }
+    // The active policy's state must only advance once per run
+    if (!policy || policy == active)
+        return;
+
+    shadow_rf = clamp_val(policy->decide(in), 1UL, in->max_factor);
+    diff = shadow_rf > active_rf ? shadow_rf - active_rf : active_rf - shadow_rf;
+
+    shadow.runs++;
+    if (shadow_rf == active_rf)
+        shadow.agreements++;
+    else if (shadow_rf > active_rf)
+        shadow.shadow_higher++;
+    else
+        shadow.shadow_lower++;
+    shadow.abs_diff_sum += diff;
+    shadow.max_abs_diff = max(shadow.max_abs_diff, diff);
+
+    d = &shadow.log[shadow.log_head];
+    d->time = in->now;
+    d->workload = in->workload;
+    d->active_rf = active_rf;
+    d->shadow_rf = shadow_rf;
+    shadow.log_head = (shadow.log_head + 1) % SHADOW_LOG_LEN;
+}
+
+static struct monitor_policy *policy_find(const char *name)
+{
+    struct monitor_policy *p;
+
+    list_for_each_entry(p, &monitor_policy_list, list) {
+        if (sysfs_streq(name, p->name))
+            return p;
+    }
+    return NULL;
+}
+
+// Caller holds policy_registry_mutex
+static int policy_activate(struct monitor_policy *policy)
+{
+    struct monitor_policy *old = rcu_dereference_protected(active_policy, lockdep_is_held(&policy_registry_mutex));
+
+    if (old == policy)
+        return 0;
+    // Pin the module providing the active policy, it can only go away once deselected
+    if (!try_module_get(policy->owner))
+        return -ENODEV;
+    rcu_assign_pointer(active_policy, policy);
+    WRITE_ONCE(policy_switch_gen, policy_switch_gen + 1);
+    module_put(old->owner);
+    printk(KERN_INFO "%s: Adjustment policy set to %s\n", DEVICE_NAME, policy->name);
+    return 0;
+}
+
+int auto_monitor_register_policy(struct monitor_policy *policy)
+{
+    int ret = 0;
+
+    if (!policy->name || !policy->decide)
+        return -EINVAL;
+
+    mutex_lock(&policy_registry_mutex);
+    if (policy_find(policy->name)) {
+        ret = -EEXIST;
+        goto out;
+    }
+    if (policy->init) {
+        ret = policy->init();
+        if (ret)
+            goto out;
+    }
+    list_add_tail_rcu(&policy->list, &monitor_policy_list);
+    printk(KERN_INFO "%s: Registered adjustment policy %s\n", DEVICE_NAME, policy->name);
+out:
+    mutex_unlock(&policy_registry_mutex);
+    return ret;
+}
+EXPORT_SYMBOL_GPL(auto_monitor_register_policy);
+
+void auto_monitor_unregister_policy(struct monitor_policy *policy)
+{
+    mutex_lock(&policy_registry_mutex);
+    // Fall back to the legacy policy (the core's own unload is the only time step goes away)
+    if (rcu_access_pointer(active_policy) == policy && policy != &step_policy)
+        policy_activate(&step_policy);
+    if (rcu_access_pointer(shadow_policy) == policy)
+        policy_set_shadow(NULL);
+    list_del_rcu(&policy->list);
+    mutex_unlock(&policy_registry_mutex);
+
+    // Wait until no handler run can still be inside this policy
+    synchronize_rcu();
+    if (policy->exit)
+        policy->exit();
+    printk(KERN_INFO "%s: Unregistered adjustment policy %s\n", DEVICE_NAME, policy->name);
+}
+EXPORT_SYMBOL_GPL(auto_monitor_unregister_policy);
+
+static bool builtin_registered[ARRAY_SIZE(builtin_policies)];
+
+// Only step is required (it is the fallback for everything else). Any other built-in whose init fails,
+// e.g. bpf on a kernel that refuses the struct_ops, is left out and the module loads without it.
+static int monitor_policies_init(void)
+{
+    int i, ret;
+
+    for (i = 0; i < ARRAY_SIZE(builtin_policies); i++) {
+        ret = auto_monitor_register_policy(builtin_policies[i]);
+        if (ret && builtin_policies[i] == &step_policy)
+            return ret;
+        if (ret) {
+            printk(KERN_WARNING "%s: Adjustment policy %s unavailable (%d)\n", DEVICE_NAME,
+                   builtin_policies[i]->name, ret);
+            continue;
+        }
+        builtin_registered[i] = true;
+    }
+    return 0;
+}
+
+static void monitor_policies_exit(void)
+{
+    int i;
+
+    for (i = ARRAY_SIZE(builtin_policies) - 1; i >= 0; i--) {
+        if (builtin_registered[i])
+            auto_monitor_unregister_policy(builtin_policies[i]);
+        builtin_registered[i] = false;
+    }
+}
+
+// Snapshot every signal the policies may use (caller holds monitor_config_mutex)
+static void monitor_collect_inputs(struct monitor_inputs *in, ktime_t now)
+{
+    struct adjust_config cfg;
+    unsigned long flags;
+
+    memset(in, 0, sizeof(*in));
+    in->now = now;
+
+    // One configuration for the whole run, a concurrent change applies from the next one
+    adjust_config_get(&cfg);
+    in->max_factor = cfg.max_factor;
+    in->high_threshold = cfg.high_threshold;
+    in->low_threshold = cfg.low_threshold;
+
+    // Use spin_lock to safely read simulated values (modified in HRTimer)
+    spin_lock_irqsave(&monitor_data_spinlock, flags);
+    in->sim_workload = monitor_state.current_sim_workload_level;
+    in->gpu_temp = monitor_state.simulated_gpu_temp;
+    in->memory_pressure = monitor_state.simulated_memory_pressure;
+    spin_unlock_irqrestore(&monitor_data_spinlock, flags);
+
+    in->io_utilization = monitor_state.io_utilization;
+    in->net_utilization = monitor_state.net_utilization;
+    in->irq_load = monitor_state.irq_load;
+    in->steal_time = monitor_state.steal_time;
+    in->reclaim_pressure = monitor_state.reclaim_pressure;
+    in->watch_starvation = monitor_state.watch_starvation;
+    in->slo_p99_us = monitor_state.slo_p99_us;
+    in->slo_throughput = monitor_state.slo_throughput;
+    in->resource_factor = monitor_state.resource_allocation_factor;
+
+    in->workload = monitor_effective_workload(in, in->sim_workload);
+    in->raw_workload = in->workload;
+}
+
+// Sysfs: /sys/kernel/auto_monitor/policy/
+static ssize_t policy_active_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct monitor_policy *p, *active;
+    ssize_t len = 0;
+
+    // List all policies with the active one in brackets, like the kernel's scheduler/governor files
+    mutex_lock(&policy_registry_mutex);
+    active = rcu_dereference_protected(active_policy, lockdep_is_held(&policy_registry_mutex));
+    list_for_each_entry(p, &monitor_policy_list, list)
+        len += scnprintf(buf + len, PAGE_SIZE - len, p == active ? "[%s] " : "%s ", p->name);
+    mutex_unlock(&policy_registry_mutex);
+    buf[len - 1] = '\n';
+    return len;
+}
+
+static ssize_t policy_active_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct monitor_policy *p;
+    int ret;
+
+    mutex_lock(&policy_registry_mutex);
+    p = policy_find(buf);
+    ret = p ? policy_activate(p) : -EINVAL;
+    mutex_unlock(&policy_registry_mutex);
+    return ret ? ret : count;
+}
+
+static ssize_t policy_shadow_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct monitor_policy *p;
+    ssize_t len;
+
+    mutex_lock(&policy_registry_mutex);
+    p = rcu_dereference_protected(shadow_policy, lockdep_is_held(&policy_registry_mutex));
+    len = sprintf(buf, "%s\n", p ? p->name : "none");
+    mutex_unlock(&policy_registry_mutex);
+    return len;
+}
+
+static ssize_t policy_shadow_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct monitor_policy *p = NULL;
+    int ret;
+
+    mutex_lock(&policy_registry_mutex);
+    if (!sysfs_streq(buf, "none")) {
+        p = policy_find(buf);
+        if (!p) {
+            mutex_unlock(&policy_registry_mutex);
+            return -EINVAL;
+        }
+    }
+    ret = policy_set_shadow(p);
+    mutex_unlock(&policy_registry_mutex);
+    return ret ? ret : count;
+}
+
+// Caller holds monitor_config_mutex
+static int shadow_stats(char *buf, size_t size)
+{
+    struct shadow_decision *d;
+    unsigned int i, n;
+    int len;
+
+    len = scnprintf(buf, size, "runs %llu\nagreements %llu\nshadow_higher %llu\nshadow_lower %llu\n"
+                    "mean_abs_diff %llu\nmax_abs_diff %lu\n",
+                    shadow.runs, shadow.agreements, shadow.shadow_higher, shadow.shadow_lower,
+                    shadow.runs ? div64_u64(shadow.abs_diff_sum * 1000, shadow.runs) : 0, shadow.max_abs_diff);
+
+    // Recent would-be decisions, oldest first (mean_abs_diff is in milli-factor)
+    n = min_t(u64, shadow.runs, SHADOW_LOG_LEN);
+    len += scnprintf(buf + len, size - len, "time_ms workload active shadow\n");
+    for (i = 0; i < n; i++) {
+        d = &shadow.log[(shadow.log_head + SHADOW_LOG_LEN - n + i) % SHADOW_LOG_LEN];
+        len += scnprintf(buf + len, size - len, "%lld %lu %lu %lu\n", ktime_to_ms(d->time), d->workload,
+                         d->active_rf, d->shadow_rf);
+    }
+    return len;
+}
+
+static ssize_t policy_shadow_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len;
+
+    mutex_lock(&monitor_config_mutex);
+    len = shadow_stats(buf, PAGE_SIZE);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+// Stats of every registered policy, one "policy <name>" block each, then the shadow comparison
+static ssize_t policy_stats_all_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct monitor_policy *p;
+    ssize_t len = 0;
+
+    mutex_lock(&monitor_config_mutex);
+    rcu_read_lock();
+    list_for_each_entry_rcu(p, &monitor_policy_list, list) {
+        if (!p->stats)
+            continue;
+        len += scnprintf(buf + len, PAGE_SIZE - len, "policy %s\n", p->name);
+        len += p->stats(buf + len, PAGE_SIZE - len);
+    }
+    p = rcu_dereference(shadow_policy);
+    if (p) {
+        len += scnprintf(buf + len, PAGE_SIZE - len, "shadow %s\n", p->name);
+        len += shadow_stats(buf + len, PAGE_SIZE - len);
+    }
+    rcu_read_unlock();
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+// Stats of one built-in policy
+struct policy_stats_attr {
+    struct kobj_attribute attr;
+    struct monitor_policy *policy;
+};
+
+static ssize_t policy_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct policy_stats_attr *a = container_of(attr, struct policy_stats_attr, attr);
+    ssize_t len;
+
+    mutex_lock(&monitor_config_mutex);
+    len = a->policy->stats(buf, PAGE_SIZE);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+#define POLICY_STATS(_name, _policy)                                                    \
+    static struct policy_stats_attr _name##_stats = {                                   \
+        .attr = __ATTR(_name, 0444, policy_stats_show, NULL),                           \
+        .policy = &(_policy),                                                           \
+    }
+
+// Numeric policy tunables: one show/store pair, bounds kept next to each attribute
+struct policy_tunable {
+    struct kobj_attribute attr;
+    unsigned long *value;
+    unsigned long min, max;
+};
+
+static ssize_t policy_tunable_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct policy_tunable *t = container_of(attr, struct policy_tunable, attr);
+    unsigned long value;
+
+    mutex_lock(&monitor_config_mutex);
+    value = *t->value;
+    mutex_unlock(&monitor_config_mutex);
+    return sprintf(buf, "%lu\n", value);
+}
+
+static ssize_t policy_tunable_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct policy_tunable *t = container_of(attr, struct policy_tunable, attr);
+    unsigned long value;
+
+    if (kstrtoul(buf, 10, &value) < 0 || value < t->min || value > t->max)
+        return -EINVAL;
+
+    mutex_lock(&monitor_config_mutex);
+    *t->value = value;
+    mutex_unlock(&monitor_config_mutex);
+    return count;
+}
+
+#define POLICY_TUNABLE(_name, _var, _min, _max)                                         \
+    static struct policy_tunable _name##_tunable = {                                    \
+        .attr = __ATTR(_name, 0664, policy_tunable_show, policy_tunable_store),         \
+        .value = &(_var),                                                               \
+        .min = (_min),                                                                  \
+        .max = (_max),                                                                  \
+    }
+
+static ssize_t stability_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len;
+    mutex_lock(&monitor_config_mutex);
+    len = sprintf(buf, "smoothed_workload %lld\nhysteresis_holds %lu\ndwell_suppressed %lu\ncooldown_suppressed %lu\n",
+                  ewma_workload < 0 ? 0 : div_s64(ewma_workload + 500, 1000),
+                  hysteresis_holds, dwell_suppressed, cooldown_suppressed);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t bandit_reward_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < ARRAY_SIZE(bandit_reward_names); i++)
+        len += sprintf(buf + len, i == bandit_reward ? "[%s] " : "%s ", bandit_reward_names[i]);
+    mutex_unlock(&monitor_config_mutex);
+    buf[len - 1] = '\n';
+    return len;
+}
+
+static ssize_t bandit_reward_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    int i = sysfs_match_string(bandit_reward_names, buf);
+
+    if (i < 0)
+        return i;
+
+    mutex_lock(&monitor_config_mutex);
+    if (i != bandit_reward) {
+        // Estimates under a different reward are meaningless
+        bandit_reward = i;
+        memset(bandit_arms, 0, sizeof(bandit_arms));
+        bandit.arm = 0;
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return count;
+}
+
+static ssize_t signal_filter_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < ARRAY_SIZE(signal_filter_names); i++)
+        len += sprintf(buf + len, i == signal_filter ? "[%s] " : "%s ", signal_filter_names[i]);
+    mutex_unlock(&monitor_config_mutex);
+    buf[len - 1] = '\n';
+    return len;
+}
+
+static ssize_t signal_filter_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    int i = sysfs_match_string(signal_filter_names, buf);
+
+    if (i < 0)
+        return i;
+    mutex_lock(&monitor_config_mutex);
+    signal_filter = i;
+    mutex_unlock(&monitor_config_mutex);
+    return count;
+}
+
+// One line per regime: "<regime> <high> <low> <step>"
+static ssize_t regime_params_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len = 0;
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < REGIME_COUNT; i++)
+        len += sprintf(buf + len, "%s %lu %lu %lu\n", regime_names[i], regime_params[i].high,
+                       regime_params[i].low, regime_params[i].step);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
 
-// Global data structure for tracking system data
-struct auto_monitor_data {
-    ktime_t last_check_time;
-    unsigned long current_sim_workload_level;   // 0-MAX_WORKLOAD_LEVEL (simulated %)
-    unsigned long resource_allocation_factor;   // 1-MAX_RESOURCE_FACTOR (simulated resource units)
-    atomic_t critical_alerts;                   // Atomic counter for critical events
-    atomic_t timer_ticks;                       // To count timer firings
-    unsigned long simulated_gpu_temp;           // Simulated temperature (degrees Celsius)
-    unsigned long simulated_memory_pressure;    // 0-MAX_MEMORY_PRESSURE (simulated %)
-};
-static struct auto_monitor_data monitor_state;
+static ssize_t regime_params_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct regime_params p;
+    char name[16];
+    int i;
 
-// Synchronization
-static DEFINE_SPINLOCK(monitor_data_spinlock); // Protects monitor_state fields from access by HRTimer callback (atomic context)
-static struct mutex monitor_config_mutex;     // Protects monitor_state fields from access by workqueue and user-space (process context)
+    if (sscanf(buf, "%15s %lu %lu %lu", name, &p.high, &p.low, &p.step) != 4)
+        return -EINVAL;
+    i = match_string(regime_names, ARRAY_SIZE(regime_names), name);
+    if (i < 0)
+        return i;
+    if (p.low >= p.high || p.high > MAX_WORKLOAD_LEVEL || !p.step || p.step >= AUTO_MONITOR_FACTOR_LIMIT)
+        return -EINVAL;
 
-// HRTimer
-static struct hrtimer monitor_hrtimer;
-#define HRTIMER_INTERVAL_MS 100
+    mutex_lock(&monitor_config_mutex);
+    regime_params[i] = p;
+    mutex_unlock(&monitor_config_mutex);
+    return count;
+}
 
-// Workqueue
-static struct workqueue_struct *monitor_wq;
-static struct work_struct monitor_work;
+static ssize_t kalman_stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    ssize_t len;
 
-// Character Device
-static int major_number;
-static struct class* auto_monitor_class = NULL;
-static struct device* auto_monitor_device = NULL;
-#define DEVICE_NAME "auto_monitor"
-#define CLASS_NAME "auto_monitor_class"
+    // Level, rate, uncertainty and innovation in milli-percent
+    mutex_lock(&monitor_config_mutex);
+    len = sprintf(buf, "level %lld\nrate %lld\nstddev %llu\ninnovation %lld\n", kalman.x[0], kalman.x[1],
+                  (unsigned long long)int_sqrt64(kalman.p[0][0]), kalman.innovation);
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
 
-// Sysfs Attributes
-static ssize_t workload_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
-static ssize_t workload_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count);
-static ssize_t resource_factor_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
-static ssize_t alerts_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf);
+static struct kobj_attribute policy_active_attribute = __ATTR(active, 0664, policy_active_show, policy_active_store);      // Read/Write
+static struct kobj_attribute policy_stats_all_attribute = __ATTR(stats, 0444, policy_stats_all_show, NULL);              // Read-only
+static struct kobj_attribute policy_shadow_attribute = __ATTR(shadow, 0664, policy_shadow_show, policy_shadow_store);      // Read/Write
+static struct kobj_attribute policy_shadow_stats_attribute = __ATTR(shadow_stats, 0444, policy_shadow_stats_show, NULL);  // Read-only
 
-static struct kobj_attribute workload_attribute = __ATTR(current_workload, 0664, workload_show, workload_store);    // Read/Write
-static struct kobj_attribute resource_attribute = __ATTR(resource_factor, 0444, resource_factor_show, NULL);        // Read-only
-static struct kobj_attribute alerts_attribute = __ATTR(critical_alerts, 0444, alerts_show, NULL);                   // Read-only
+// Read-only
+POLICY_STATS(pid_output, pid_policy);
+POLICY_STATS(forecast, forecast_policy);
+POLICY_STATS(mpc, mpc_policy);
+POLICY_STATS(weighted, weighted_policy);
+POLICY_STATS(regime, regime_policy);
+POLICY_STATS(bandit_table, bandit_policy);
+POLICY_STATS(model, model_policy);
+static struct kobj_attribute stability_stats_attribute = __ATTR(stability, 0444, stability_stats_show, NULL);            // Read-only
+static struct kobj_attribute bandit_reward_attribute = __ATTR(bandit_reward, 0664, bandit_reward_show, bandit_reward_store);   // Read/Write
+static struct kobj_attribute signal_filter_attribute = __ATTR(filter, 0664, signal_filter_show, signal_filter_store);          // Read/Write
+static struct kobj_attribute regime_params_attribute = __ATTR(regime_params, 0664, regime_params_show, regime_params_store);   // Read/Write
+static struct kobj_attribute kalman_stats_attribute = __ATTR(kalman, 0444, kalman_stats_show, NULL);                         // Read-only
 
-static struct attribute *auto_monitor_attrs[] = {
-    &workload_attribute.attr,
-    &resource_attribute.attr,
-    &alerts_attribute.attr,
+// Read/Write. Release thresholds outside the configured band act as the band edge (the band is a runtime
+// setting, so they are clamped where they are used), and the EWMA must keep some weight on the newest sample.
+POLICY_TUNABLE(pid_setpoint, pid_setpoint, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(pid_kp, pid_kp, 0, 100 * PID_SCALE);
+POLICY_TUNABLE(pid_ki, pid_ki, 0, 100 * PID_SCALE);
+POLICY_TUNABLE(pid_kd, pid_kd, 0, 100 * PID_SCALE);
+POLICY_TUNABLE(ewma_weight, stability_ewma_weight, 1, 100);
+POLICY_TUNABLE(high_release, stability_high_release, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(low_release, stability_low_release, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(dwell_ms, stability_dwell_ms, 0, 60 * MSEC_PER_SEC);
+POLICY_TUNABLE(cooldown_ms, stability_cooldown_ms, 0, 60 * MSEC_PER_SEC);
+POLICY_TUNABLE(forecast_horizon_ms, forecast_horizon_ms, HRTIMER_INTERVAL_MS, (FORECAST_MAX_HORIZON - 1) * HRTIMER_INTERVAL_MS);
+POLICY_TUNABLE(forecast_season, forecast_season, 1, FORECAST_MAX_SEASON);
+POLICY_TUNABLE(forecast_alpha, forecast_alpha, 1, 100);
+POLICY_TUNABLE(forecast_beta, forecast_beta, 0, 100);
+POLICY_TUNABLE(forecast_gamma, forecast_gamma, 0, 100);
+POLICY_TUNABLE(mpc_horizon, mpc_horizon, 1, MPC_MAX_HORIZON);
+POLICY_TUNABLE(mpc_cost_resource, mpc_cost_resource, 0, 1000000);
+POLICY_TUNABLE(mpc_cost_move, mpc_cost_move, 0, 1000000);
+POLICY_TUNABLE(mpc_cost_slo, mpc_cost_slo, 0, 1000000);
+POLICY_TUNABLE(mpc_workload_target, mpc_workload_target, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(mpc_workload_max, mpc_workload_max, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(mpc_temp_max, mpc_temp_max, 0, 150);
+POLICY_TUNABLE(weighted_workload, weighted_workload, 0, 1000);
+POLICY_TUNABLE(weighted_temp, weighted_temp, 0, 1000);
+POLICY_TUNABLE(weighted_memory, weighted_memory, 0, 1000);
+POLICY_TUNABLE(weighted_temp_max, weighted_temp_max, WEIGHTED_TEMP_IDLE + 1, 150);
+POLICY_TUNABLE(weighted_memory_max, weighted_memory_max, 1, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(weighted_margin, weighted_margin, 0, 50);
+POLICY_TUNABLE(regime_idle_max, regime_idle_max, 0, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(regime_ramp_delta, regime_ramp_delta, 1, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(regime_burst_delta, regime_burst_delta, 1, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(regime_burst_count, regime_burst_count, 1, REGIME_WINDOW);
+POLICY_TUNABLE(regime_noise, regime_noise, 1, MAX_WORKLOAD_LEVEL);
+POLICY_TUNABLE(regime_confirm, regime_confirm, 1, REGIME_WINDOW);
+POLICY_TUNABLE(bandit_epoch_ms, bandit_epoch_ms, HRTIMER_INTERVAL_MS, 600 * MSEC_PER_SEC);
+POLICY_TUNABLE(bandit_explore_pct, bandit_explore_pct, 0, 100);
+POLICY_TUNABLE(kalman_r_workload, kalman_r_workload, 0, 10000);
+POLICY_TUNABLE(kalman_q_level, kalman_q_level, 0, 10000000);
+POLICY_TUNABLE(kalman_q_rate, kalman_q_rate, 0, 10000000);
+
+static struct attribute *policy_attrs[] = {
+    &policy_active_attribute.attr,
+    &policy_stats_all_attribute.attr,
+    &policy_shadow_attribute.attr,
+    &policy_shadow_stats_attribute.attr,
+    &pid_setpoint_tunable.attr.attr,
+    &pid_kp_tunable.attr.attr,
+    &pid_ki_tunable.attr.attr,
+    &pid_kd_tunable.attr.attr,
+    &pid_output_stats.attr.attr,
+    &ewma_weight_tunable.attr.attr,
+    &high_release_tunable.attr.attr,
+    &low_release_tunable.attr.attr,
+    &dwell_ms_tunable.attr.attr,
+    &cooldown_ms_tunable.attr.attr,
+    &stability_stats_attribute.attr,
+    &forecast_horizon_ms_tunable.attr.attr,
+    &forecast_season_tunable.attr.attr,
+    &forecast_alpha_tunable.attr.attr,
+    &forecast_beta_tunable.attr.attr,
+    &forecast_gamma_tunable.attr.attr,
+    &forecast_stats.attr.attr,
+    &mpc_horizon_tunable.attr.attr,
+    &mpc_cost_resource_tunable.attr.attr,
+    &mpc_cost_move_tunable.attr.attr,
+    &mpc_cost_slo_tunable.attr.attr,
+    &mpc_workload_target_tunable.attr.attr,
+    &mpc_workload_max_tunable.attr.attr,
+    &mpc_temp_max_tunable.attr.attr,
+    &mpc_stats.attr.attr,
+    &weighted_workload_tunable.attr.attr,
+    &weighted_temp_tunable.attr.attr,
+    &weighted_memory_tunable.attr.attr,
+    &weighted_temp_max_tunable.attr.attr,
+    &weighted_memory_max_tunable.attr.attr,
+    &weighted_margin_tunable.attr.attr,
+    &weighted_stats.attr.attr,
+    &regime_idle_max_tunable.attr.attr,
+    &regime_ramp_delta_tunable.attr.attr,
+    &regime_burst_delta_tunable.attr.attr,
+    &regime_burst_count_tunable.attr.attr,
+    &regime_noise_tunable.attr.attr,
+    &regime_confirm_tunable.attr.attr,
+    &regime_params_attribute.attr,
+    &regime_stats.attr.attr,
+    &bandit_epoch_ms_tunable.attr.attr,
+    &bandit_explore_pct_tunable.attr.attr,
+    &bandit_reward_attribute.attr,
+    &bandit_table_stats.attr.attr,
+    &signal_filter_attribute.attr,
+    &kalman_r_workload_tunable.attr.attr,
+    &kalman_q_level_tunable.attr.attr,
+    &kalman_q_rate_tunable.attr.attr,
+    &kalman_stats_attribute.attr,
+    &model_stats.attr.attr,
     NULL,
 };
 
-static struct attribute_group auto_monitor_attr_group = {
-    .attrs = auto_monitor_attrs,
+static const struct attribute_group policy_attr_group = {
+    .name = "policy",
+    .attrs = policy_attrs,
 };
 
-static struct kobject *auto_monitor_kobj;
+// Alert Rules (process context, monitor_config_mutex held)
+// Operators define alerts as "<name> <metric>[:rate] <op> <threshold> [for <ms>] [info|warning|critical]",
+// e.g. "mem_high memory_pressure > 70 for 5000 warning" or "temp_rising gpu_temp:rate > 2 critical".
+// Every work-handler run evaluates each rule once against the same input snapshot the policies saw, so a
+// rule costs a comparison and a few fields of state. A rule goes pending when its condition starts to hold,
+// fires once it has held for the whole duration and resolves as soon as it stops holding. Firing and
+// resolving are logged and notified on alerts/firing (poll()able), and critical rules also raise a
+// critical alert.
+#define ALERT_RULES_MAX 32
+#define ALERT_NAME_LEN 24
+#define ALERT_EVENTS_LEN 32
+#define ALERT_RATE_INTERVAL_MS 1000         // Rates are measured over at least this long
+#define ALERT_DURATION_MAX_MS (24 * 60 * 60 * MSEC_PER_SEC)  // Longest "for" a rule accepts (one day)
 
-// Function Prototypes
-static int auto_monitor_open(struct inode *inode, struct file *file);
-static int auto_monitor_release(struct inode *inode, struct file *file);
-static ssize_t auto_monitor_read(struct file *file, char __user *buf, size_t len, loff_t *offset);
-static ssize_t auto_monitor_write(struct file *file, const char __user *buf, size_t len, loff_t *offset);
+enum alert_op { ALERT_OP_GT, ALERT_OP_GE, ALERT_OP_LT, ALERT_OP_LE };
+enum alert_severity { ALERT_INFO, ALERT_WARNING, ALERT_CRITICAL, ALERT_SEVERITY_COUNT };
+enum alert_state { ALERT_INACTIVE, ALERT_PENDING, ALERT_FIRING };
 
-// Map use-space file system calls to functions
-static struct file_operations fops = {
-    .owner = THIS_MODULE,
-    .open = auto_monitor_open,
-    .release = auto_monitor_release,
-    .read = auto_monitor_read,
-    .write = auto_monitor_write,
+static const char * const alert_op_names[] = { ">", ">=", "<", "<=" };
+static const char * const alert_severity_names[] = { "info", "warning", "critical" };
+static const char * const alert_state_names[] = { "inactive", "pending", "firing" };
+
+// Metrics rules can refer to, all unsigned long fields of struct monitor_inputs
+static const struct {
+    const char *name;
+    size_t offset;
+} alert_metrics[] = {
+    { "workload", offsetof(struct monitor_inputs, workload) },
+    { "raw_workload", offsetof(struct monitor_inputs, raw_workload) },
+    { "sim_workload", offsetof(struct monitor_inputs, sim_workload) },
+    { "gpu_temp", offsetof(struct monitor_inputs, gpu_temp) },
+    { "memory_pressure", offsetof(struct monitor_inputs, memory_pressure) },
+    { "io_utilization", offsetof(struct monitor_inputs, io_utilization) },
+    { "net_utilization", offsetof(struct monitor_inputs, net_utilization) },
+    { "irq_load", offsetof(struct monitor_inputs, irq_load) },
+    { "steal_time", offsetof(struct monitor_inputs, steal_time) },
+    { "reclaim_pressure", offsetof(struct monitor_inputs, reclaim_pressure) },
+    { "watch_starvation", offsetof(struct monitor_inputs, watch_starvation) },
+    { "slo_p99_us", offsetof(struct monitor_inputs, slo_p99_us) },
+    { "slo_throughput", offsetof(struct monitor_inputs, slo_throughput) },
+    { "resource_factor", offsetof(struct monitor_inputs, resource_factor) },
+};
+
+struct alert_rule {
+    bool used;
+    char name[ALERT_NAME_LEN];
+    unsigned int metric;                    // Index into alert_metrics
+    bool rate;                              // Compare the change per second instead of the value
+    enum alert_op op;
+    s64 threshold;                          // milli-units (per second for rates)
+    unsigned long duration_ms;
+    enum alert_severity severity;
+    // Evaluation state
+    enum alert_state state;
+    ktime_t since;                          // Condition holding since (pending) or fired at (firing)
+    s64 value;                              // Latest evaluated value, milli-units
+    bool have_prev;                         // Rate rules: previous sample
+    s64 prev;
+    ktime_t prev_time;
+    u64 fires;
+};
+
+struct alert_event {
+    ktime_t time;
+    char name[ALERT_NAME_LEN];
+    enum alert_severity severity;
+    bool fired;                             // false = resolved
+    s64 value;
+};
+
+static struct alert_rule alert_rules[ALERT_RULES_MAX];
+static struct {
+    u64 fired[ALERT_SEVERITY_COUNT];
+    u64 resolved;
+    unsigned int firing;                    // Rules currently firing
+    struct alert_event events[ALERT_EVENTS_LEN];    // Ring, newest at (events_head - 1)
+    unsigned int events_head;
+    u64 events_total;
+} alert_stats;
+
+// Parse a decimal with up to three fractional digits ("-2", "0.5") into milli-units
+static int alert_parse_milli(const char *s, s64 *out)
+{
+    bool neg = *s == '-';
+    s64 whole = 0, frac = 0;
+    int digits = 0;
+
+    if (neg)
+        s++;
+    if (!isdigit(*s))
+        return -EINVAL;
+    while (isdigit(*s)) {
+        whole = whole * 10 + (*s++ - '0');
+        if (whole > S64_MAX / 10000)
+            return -ERANGE;
+    }
+    if (*s == '.') {
+        s++;
+        while (isdigit(*s) && digits < 3) {
+            frac = frac * 10 + (*s++ - '0');
+            digits++;
+        }
+    }
+    if (*s)
+        return -EINVAL;
+    while (digits++ < 3)
+        frac *= 10;
+    *out = neg ? -(whole * 1000 + frac) : whole * 1000 + frac;
+    return 0;
+}
+
+static int alert_format_milli(char *buf, size_t size, s64 v)
+{
+    u64 a = v < 0 ? -(u64)v : v;
+
+    if (a % 1000)
+        return scnprintf(buf, size, "%s%llu.%03llu", v < 0 ? "-" : "", a / 1000, a % 1000);
+    return scnprintf(buf, size, "%s%llu", v < 0 ? "-" : "", a / 1000);
+}
+
+static struct alert_rule *alert_rule_find(const char *name)
+{
+    int i;
+
+    for (i = 0; i < ALERT_RULES_MAX; i++) {
+        if (alert_rules[i].used && !strcmp(alert_rules[i].name, name))
+            return &alert_rules[i];
+    }
+    return NULL;
+}
+
+static void alert_log_event(const struct alert_rule *r, ktime_t now, bool fired)
+{
+    struct alert_event *e = &alert_stats.events[alert_stats.events_head];
+
+    e->time = now;
+    strscpy(e->name, r->name, sizeof(e->name));
+    e->severity = r->severity;
+    e->fired = fired;
+    e->value = r->value;
+    alert_stats.events_head = (alert_stats.events_head + 1) % ALERT_EVENTS_LEN;
+    alert_stats.events_total++;
+}
+
+// Returns true when the rule's condition holds for this sample
+static bool alert_rule_check(struct alert_rule *r, const struct monitor_inputs *in)
+{
+    s64 x = (s64)*(const unsigned long *)((const char *)in + alert_metrics[r->metric].offset) * 1000;
+    s64 dt_ms;
+
+    if (r->rate) {
+        dt_ms = r->have_prev ? ktime_ms_delta(in->now, r->prev_time) : 0;
+        // Per-sample differences of step-wise signals are mostly noise, keep the last rate until a full
+        // interval has passed
+        if (r->have_prev && dt_ms < ALERT_RATE_INTERVAL_MS)
+            goto compare;
+        if (r->have_prev)
+            r->value = div64_s64((x - r->prev) * MSEC_PER_SEC, dt_ms);
+        r->prev = x;
+        r->prev_time = in->now;
+        if (!r->have_prev) {
+            r->have_prev = true;
+            return false;
+        }
+    } else {
+        r->value = x;
+    }
+
+compare:
+    switch (r->op) {
+    case ALERT_OP_GT:
+        return r->value > r->threshold;
+    case ALERT_OP_GE:
+        return r->value >= r->threshold;
+    case ALERT_OP_LT:
+        return r->value < r->threshold;
+    default:
+        return r->value <= r->threshold;
+    }
+}
+
+static void alert_rules_evaluate(const struct monitor_inputs *in)
+{
+    struct alert_rule *r;
+    bool changed = false;
+    char value[24];
+    int i;
+
+    for (i = 0; i < ALERT_RULES_MAX; i++) {
+        r = &alert_rules[i];
+        if (!r->used)
+            continue;
+
+        if (!alert_rule_check(r, in)) {
+            if (r->state == ALERT_FIRING) {
+                alert_stats.firing--;
+                alert_stats.resolved++;
+                alert_log_event(r, in->now, false);
+                printk(KERN_INFO "%s: Alert %s resolved\n", DEVICE_NAME, r->name);
+                changed = true;
+            }
+            r->state = ALERT_INACTIVE;
+            continue;
+        }
+
+        if (r->state == ALERT_INACTIVE) {
+            r->state = ALERT_PENDING;
+            r->since = in->now;
+        }
+        if (r->state != ALERT_PENDING || ktime_ms_delta(in->now, r->since) < (s64)r->duration_ms)
+            continue;
+
+        r->state = ALERT_FIRING;
+        r->since = in->now;
+        r->fires++;
+        alert_stats.fired[r->severity]++;
+        alert_stats.firing++;
+        alert_log_event(r, in->now, true);
+        alert_format_milli(value, sizeof(value), r->value);
+        if (r->severity == ALERT_CRITICAL) {
+            monitor_raise_alert(r->name, div_s64(max_t(s64, r->value, 0), 1000));
+            printk(KERN_CRIT "%s: Critical Alert: %s (%s%s %s)\n", DEVICE_NAME, r->name,
+                   alert_metrics[r->metric].name, r->rate ? ":rate" : "", value);
+        } else if (r->severity == ALERT_WARNING) {
+            printk(KERN_WARNING "%s: Alert %s firing (%s%s %s)\n", DEVICE_NAME, r->name,
+                   alert_metrics[r->metric].name, r->rate ? ":rate" : "", value);
+        } else {
+            printk(KERN_INFO "%s: Alert %s firing (%s%s %s)\n", DEVICE_NAME, r->name,
+                   alert_metrics[r->metric].name, r->rate ? ":rate" : "", value);
+        }
+        changed = true;
+    }
+
+    // Wake up poll()/select() waiters on alerts/firing
+    if (changed)
+        sysfs_notify(auto_monitor_kobj, "alerts", "firing");
+}
+
+// Sysfs: /sys/kernel/auto_monitor/alerts/
+static int alert_rule_format(char *buf, size_t size, const struct alert_rule *r)
+{
+    int len;
+
+    len = scnprintf(buf, size, "%s %s%s %s ", r->name, alert_metrics[r->metric].name, r->rate ? ":rate" : "",
+                    alert_op_names[r->op]);
+    len += alert_format_milli(buf + len, size - len, r->threshold);
+    len += scnprintf(buf + len, size - len, " for %lu %s", r->duration_ms, alert_severity_names[r->severity]);
+    return len;
+}
+
+static ssize_t alert_rules_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct alert_rule *r;
+    ssize_t len = 0;
+    int i;
+
+    // One rule per line: its definition, then state, latest value and how often it fired
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < ALERT_RULES_MAX; i++) {
+        r = &alert_rules[i];
+        if (!r->used)
+            continue;
+        len += alert_rule_format(buf + len, PAGE_SIZE - len, r);
+        len += scnprintf(buf + len, PAGE_SIZE - len, " : %s ", alert_state_names[r->state]);
+        len += alert_format_milli(buf + len, PAGE_SIZE - len, r->value);
+        len += scnprintf(buf + len, PAGE_SIZE - len, " fires %llu\n", r->fires);
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+// "<name> <metric>[:rate] <op> <threshold> [for <ms>] [<severity>]" adds or replaces a rule, "-<name>" deletes it
+static ssize_t alert_rules_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count)
+{
+    struct alert_rule rule = { .used = true, .severity = ALERT_WARNING }, *slot;
+    char line[128], *cursor, *tok, *argv[8], *metric;
+    bool was_firing = false;
+    int argc = 0, i, n, ret;
+
+    if (count >= sizeof(line))
+        return -EINVAL;
+    strscpy(line, buf, sizeof(line));
+    cursor = strim(line);
+    while ((tok = strsep(&cursor, " \t")) != NULL) {
+        if (!*tok)
+            continue;
+        if (argc == ARRAY_SIZE(argv))
+            return -EINVAL;
+        argv[argc++] = tok;
+    }
+    if (!argc)
+        return -EINVAL;
+
+    if (argv[0][0] == '-') {
+        if (argc != 1)
+            return -EINVAL;
+        mutex_lock(&monitor_config_mutex);
+        slot = alert_rule_find(argv[0] + 1);
+        if (slot) {
+            was_firing = slot->state == ALERT_FIRING;
+            if (was_firing)
+                alert_stats.firing--;
+            memset(slot, 0, sizeof(*slot));
+        }
+        mutex_unlock(&monitor_config_mutex);
+        if (!slot)
+            return -ENOENT;
+        if (was_firing)
+            sysfs_notify(auto_monitor_kobj, "alerts", "firing");
+        return count;
+    }
+
+    if (argc < 4 || strlen(argv[0]) >= ALERT_NAME_LEN)
+        return -EINVAL;
+    strscpy(rule.name, argv[0], sizeof(rule.name));
+
+    metric = strsep(&argv[1], ":");
+    if (argv[1]) {
+        if (strcmp(argv[1], "rate"))
+            return -EINVAL;
+        rule.rate = true;
+    }
+    for (i = 0; i < ARRAY_SIZE(alert_metrics) && strcmp(alert_metrics[i].name, metric); i++)
+        ;
+    if (i == ARRAY_SIZE(alert_metrics))
+        return -EINVAL;
+    rule.metric = i;
+
+    n = match_string(alert_op_names, ARRAY_SIZE(alert_op_names), argv[2]);
+    if (n < 0)
+        return n;
+    rule.op = n;
+    ret = alert_parse_milli(argv[3], &rule.threshold);
+    if (ret)
+        return ret;
+
+    for (i = 4; i < argc; i++) {
+        if (!strcmp(argv[i], "for") && i + 1 < argc) {
+            if (kstrtoul(argv[++i], 10, &rule.duration_ms) < 0)
+                return -EINVAL;
+            if (rule.duration_ms > ALERT_DURATION_MAX_MS)
+                return -ERANGE;
+            continue;
+        }
+        n = match_string(alert_severity_names, ARRAY_SIZE(alert_severity_names), argv[i]);
+        if (n < 0)
+            return n;
+        rule.severity = n;
+    }
+
+    // Replacing a rule restarts its evaluation
+    mutex_lock(&monitor_config_mutex);
+    slot = alert_rule_find(rule.name);
+    if (slot) {
+        was_firing = slot->state == ALERT_FIRING;
+        if (was_firing)
+            alert_stats.firing--;
+    } else {
+        for (i = 0; i < ALERT_RULES_MAX && alert_rules[i].used; i++)
+            ;
+        slot = i < ALERT_RULES_MAX ? &alert_rules[i] : NULL;
+    }
+    if (slot)
+        *slot = rule;
+    mutex_unlock(&monitor_config_mutex);
+
+    if (!slot)
+        return -ENOSPC;
+    if (was_firing)
+        sysfs_notify(auto_monitor_kobj, "alerts", "firing");
+    return count;
+}
+
+// Rules currently firing, one per line; poll() on this file wakes up whenever the set changes
+static ssize_t alert_firing_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct alert_rule *r;
+    ssize_t len = 0;
+    ktime_t now = ktime_get();
+    int i;
+
+    mutex_lock(&monitor_config_mutex);
+    for (i = 0; i < ALERT_RULES_MAX; i++) {
+        r = &alert_rules[i];
+        if (!r->used || r->state != ALERT_FIRING)
+            continue;
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%s %s %lld ", r->name, alert_severity_names[r->severity],
+                         ktime_ms_delta(now, r->since));
+        len += alert_format_milli(buf + len, PAGE_SIZE - len, r->value);
+        len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static ssize_t alert_events_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+    struct alert_event *e;
+    unsigned int i, n;
+    ssize_t len;
+
+    // Counters, then the most recent transitions oldest first
+    mutex_lock(&monitor_config_mutex);
+    len = scnprintf(buf, PAGE_SIZE, "firing %u\nfired_info %llu\nfired_warning %llu\nfired_critical %llu\n"
+                    "resolved %llu\n",
+                    alert_stats.firing, alert_stats.fired[ALERT_INFO], alert_stats.fired[ALERT_WARNING],
+                    alert_stats.fired[ALERT_CRITICAL], alert_stats.resolved);
+    n = min_t(u64, alert_stats.events_total, ALERT_EVENTS_LEN);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "time_ms name severity event value\n");
+    for (i = 0; i < n; i++) {
+        e = &alert_stats.events[(alert_stats.events_head + ALERT_EVENTS_LEN - n + i) % ALERT_EVENTS_LEN];
+        len += scnprintf(buf + len, PAGE_SIZE - len, "%lld %s %s %s ", ktime_to_ms(e->time), e->name,
+                         alert_severity_names[e->severity], e->fired ? "fired" : "resolved");
+        len += alert_format_milli(buf + len, PAGE_SIZE - len, e->value);
+        len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+    }
+    mutex_unlock(&monitor_config_mutex);
+    return len;
+}
+
+static struct kobj_attribute alert_rules_attribute = __ATTR(rules, 0664, alert_rules_show, alert_rules_store);  // Read/Write
+static struct kobj_attribute alert_firing_attribute = __ATTR(firing, 0444, alert_firing_show, NULL);            // Read-only
+static struct kobj_attribute alert_events_attribute = __ATTR(events, 0444, alert_events_show, NULL);            // Read-only
+
+static struct attribute *alert_attrs[] = {
+    &alert_rules_attribute.attr,
+    &alert_firing_attribute.attr,
+    &alert_events_attribute.attr,
+    NULL,
+};
+
+static const struct attribute_group alert_attr_group = {
+    .name = "alerts",
+    .attrs = alert_attrs,
 };
 
 // Workqueue Handler (process context)
 static void monitor_work_handler(struct work_struct *work)
 {
-    unsigned long flags;
-    unsigned long current_wl, current_rf;
+    static unsigned long policy_seen_gen;
+    static unsigned long settled_rf;            // Factor the previous run left behind
+    static enum monitor_outcome outcome;        // Of the previous run's decision
+    struct monitor_inputs in;
+    struct monitor_policy *policy;
+    unsigned long current_rf, new_rf;
+    char signal_desc[64];
+    char policy_name[32];
+    ktime_t now = ktime_get();
 
     // Protect monitor_state with mutex (against processes that can sleep)
     mutex_lock(&monitor_config_mutex);
 
-    // Use spin_lock to safely read workload (modified in HRTimer)
-    spin_lock_irqsave(&monitor_data_spinlock, flags);
-    current_wl = monitor_state.current_sim_workload_level;
-    spin_unlock_irqrestore(&monitor_data_spinlock, flags);
+    // Refresh real metric sources (may sleep, so done outside the spinlock)
+    monitor_sources_sample(now);
+
+    monitor_collect_inputs(&in, now);
+    stability_smooth_inputs(&in, true);
+    current_rf = in.resource_factor;
+    // A factor that moved since the last run was set from outside (Sysfs, ioctl), not by a policy
+    in.last_outcome = settled_rf && current_rf != settled_rf ? MONITOR_OUTCOME_OVERRIDDEN : outcome;
+    outcome = MONITOR_OUTCOME_APPLIED;
+
+    rcu_read_lock();
+
+    // Let every policy keep its model current, so switching to it does not start cold
+    list_for_each_entry_rcu(policy, &monitor_policy_list, list) {
+        if (policy->observe)
+            policy->observe(&in);
+    }
 
-    current_rf = monitor_state.resource_allocation_factor;
+    policy = rcu_dereference(active_policy);
+    if (READ_ONCE(policy_switch_gen) != policy_seen_gen) {
+        policy_seen_gen = READ_ONCE(policy_switch_gen);
+        if (policy->reset)
+            policy->reset(&in);
+    }
+
+    // Ask the active policy for the next factor, always kept within [1, max_factor]
+    new_rf = clamp_val(policy->decide(&in), 1UL, in.max_factor);
+    strscpy(policy_name, policy->name, sizeof(policy_name));
+    shadow_evaluate(policy, policy_seen_gen, &in, new_rf);
+    rcu_read_unlock();
+
+    if (slo_target_p99_us && in.slo_p99_us)
+        snprintf(signal_desc, sizeof(signal_desc), "p99 %lu us vs target %lu us", in.slo_p99_us, slo_target_p99_us);
+    else
+        snprintf(signal_desc, sizeof(signal_desc), "%lu%%", in.workload);
 
     // Dynamic Resource Adjustment
-    // Increase resource factor if workload is high, decrease if low.
-    if (current_wl > 80 && current_rf < MAX_RESOURCE_FACTOR) {
-        monitor_state.resource_allocation_factor++;
-        printk(KERN_INFO "%s: Workload High (%lu%%), Increasing Resource Factor to %lu\n",
-               DEVICE_NAME, current_wl, monitor_state.resource_allocation_factor);
-        if (monitor_state.resource_allocation_factor == MAX_RESOURCE_FACTOR) {
-            atomic_inc(&monitor_state.critical_alerts);
+    if (new_rf > current_rf && in.steal_time >= STEAL_CONTENTION_PCT) {
+        // The hypervisor is the bottleneck, more guest resources would not help
+        steal_suppressed++;
+        outcome = MONITOR_OUTCOME_OVERRIDDEN;
+        printk(KERN_INFO "%s: Workload High (%s) but Host Contention (%lu%% steal), Holding Resource Factor %lu\n",
+               DEVICE_NAME, signal_desc, in.steal_time, current_rf);
+    } else if (new_rf != current_rf && !stability_allow(&in, current_rf, new_rf)) {
+        outcome = MONITOR_OUTCOME_DEFERRED;
+        printk(KERN_INFO "%s: Workload %s (%s), Holding Resource Factor %lu (dwell/cooldown)\n",
+               DEVICE_NAME, new_rf > current_rf ? "High" : "Low", signal_desc, current_rf);
+    } else if (new_rf > current_rf) {
+        stability_record(&in, current_rf, new_rf);
+        monitor_state.resource_allocation_factor = new_rf;
+        printk(KERN_INFO "%s: Workload High (%s), Increasing Resource Factor to %lu (%s policy)\n",
+               DEVICE_NAME, signal_desc, new_rf, policy_name);
+        if (new_rf == in.max_factor) {
+            monitor_raise_alert("Max Resources Reached", in.workload);
             printk(KERN_WARNING "%s: Critical Alert: Max Resources Reached!\n", DEVICE_NAME);
         }
-    } else if (current_wl < 20 && current_rf > 1) {
-        monitor_state.resource_allocation_factor--;
-        printk(KERN_INFO "%s: Workload Low (%lu%%), Decreasing Resource Factor to %lu\n",
-               DEVICE_NAME, current_wl, monitor_state.resource_allocation_factor);
+    } else if (new_rf < current_rf) {
+        stability_record(&in, current_rf, new_rf);
+        monitor_state.resource_allocation_factor = new_rf;
+        printk(KERN_INFO "%s: Workload Low (%s), Decreasing Resource Factor to %lu (%s policy)\n",
+               DEVICE_NAME, signal_desc, new_rf, policy_name);
     } else {
-        printk(KERN_INFO "%s: Workload Stable (%lu%%), Resource Factor %lu\n",
-               DEVICE_NAME, current_wl, monitor_state.resource_allocation_factor);
+        printk(KERN_INFO "%s: Workload Stable (%s), Resource Factor %lu (%s policy)\n",
+               DEVICE_NAME, signal_desc, current_rf, policy_name);
     }
 
+    // Alert rules see the factor this run settled on
+    in.resource_factor = monitor_state.resource_allocation_factor;
+    settled_rf = in.resource_factor;
+    alert_rules_evaluate(&in);
+
     mutex_unlock(&monitor_config_mutex);
 }
 
@@ -230,6 +6106,8 @@ static int auto_monitor_open(struct inode *inode, struct file *file)
 
 static int auto_monitor_release(struct inode *inode, struct file *file)
 {
+    if (file->private_data)
+        ring_destroy(file->private_data);
     module_put(THIS_MODULE);
     printk(KERN_INFO "%s: Device closed.\n", DEVICE_NAME);
     return 0;
@@ -237,19 +6115,23 @@ static int auto_monitor_release(struct inode *inode, struct file *file)
 
 static ssize_t auto_monitor_read(struct file *file, char __user *buf, size_t len, loff_t *offset)
 {
-    char summary_buf[256];
+    char *summary_buf;
     int len_summary;
     unsigned long flags;
 
 
     printk(KERN_INFO "%s: Read requested. Params: max_return_len=%zu, summary_offset=%lld\n", DEVICE_NAME, len, (long long)*offset);
 
+    summary_buf = kmalloc(SUMMARY_BUF_SIZE, GFP_KERNEL);
+    if (!summary_buf)
+        return -ENOMEM;
+
     // Protect monitor_state from atomic and process context
     mutex_lock(&monitor_config_mutex);
     spin_lock_irqsave(&monitor_data_spinlock, flags);
 
     // Fill summary_buf with monitor_states values
-    len_summary = snprintf(summary_buf, sizeof(summary_buf),
+    len_summary = scnprintf(summary_buf, SUMMARY_BUF_SIZE,
                    "Workload: %lu%%\nResource Factor: %lu\nCritical Alerts: %d\nSimulated GPU Temp: %luC\nSimulated Memory Pressure: %lu%%\nTimer Ticks: %d\n",
                    monitor_state.current_sim_workload_level,
                    monitor_state.resource_allocation_factor,
@@ -259,21 +6141,28 @@ static ssize_t auto_monitor_read(struct file *file, char __user *buf, size_t len
                    atomic_read(&monitor_state.timer_ticks));
 
     spin_unlock_irqrestore(&monitor_data_spinlock, flags);
+
+    // Append real metric source summaries (sleeping context, mutex still held)
+    len_summary += monitor_sources_summary(summary_buf + len_summary, SUMMARY_BUF_SIZE - len_summary);
     mutex_unlock(&monitor_config_mutex);
     
     printk(KERN_INFO "%s: Read total summary length=%d\n", DEVICE_NAME, len_summary);
 
     // Account for EOF
-    if (*offset >= len_summary)
+    if (*offset >= len_summary) {
+        kfree(summary_buf);
         return 0;
+    }
 
     // Copy summary_buf to user buf accounting for offset and max len
     ssize_t bytes_to_copy = min((size_t)len_summary - *offset, len);
 
     if (copy_to_user(buf, summary_buf + *offset, bytes_to_copy)){
         printk(KERN_ERR "%s: Failed to copy data to user space.\n", DEVICE_NAME);
+        kfree(summary_buf);
         return -EFAULT;
     }
+    kfree(summary_buf);
 
     // Update offset
     *offset += bytes_to_copy;
@@ -299,6 +6188,12 @@ static ssize_t auto_monitor_write(struct file *file, const char __user *buf, siz
     // Null terminate
     kbuf[len] = '\0';
 
+    // Application SLO report: "slo <name> <window_ms> <p50_us> <p99_us> <requests>"
+    if (strncmp(kbuf, "slo ", 4) == 0) {
+        int ret = slo_write_report(kbuf + 4);
+        return ret < 0 ? ret : len;
+    }
+
     // Simple write mechanism to set simulated workload for now (can add more functionality)
     // Convert string to unsigned long
     if (kstrtoul(kbuf, 10, &value) < 0)
@@ -324,6 +6219,40 @@ static ssize_t auto_monitor_write(struct file *file, const char __user *buf, siz
     return len;
 }
 
+static long auto_monitor_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    void __user *uarg = (void __user *)arg;
+
+    switch (cmd) {
+    case AUTO_MONITOR_IOC_CGROUP_LIST:
+        return cgroup_ioctl_list(uarg);
+    case AUTO_MONITOR_IOC_CGROUP_GET:
+        return cgroup_ioctl_get(uarg);
+    case AUTO_MONITOR_IOC_WATCH_ADD:
+        return watch_ioctl_add(uarg);
+    case AUTO_MONITOR_IOC_WATCH_DEL:
+        return watch_ioctl_del(uarg);
+    case AUTO_MONITOR_IOC_WATCH_LIST:
+        return watch_ioctl_list(uarg);
+    case AUTO_MONITOR_IOC_SLO_REPORT:
+        return slo_ioctl_report(uarg);
+    case AUTO_MONITOR_IOC_RING_CREATE:
+        return ring_ioctl_create(file, uarg);
+    case AUTO_MONITOR_IOC_MODEL_LOAD:
+        return model_ioctl_load(uarg);
+    case AUTO_MONITOR_IOC_CONFIG_GET:
+        return config_ioctl_get(uarg);
+    case AUTO_MONITOR_IOC_CONFIG_SET:
+        return config_ioctl_set(uarg);
+    default:
+        return -ENOTTY;
+    }
+}
+
+static int auto_monitor_mmap(struct file *file, struct vm_area_struct *vma)
+{
+    return ring_mmap(file, vma);
+}
 
 // Module init
 static int __init auto_monitor_init(void)
@@ -332,9 +6261,15 @@ static int __init auto_monitor_init(void)
 
     printk(KERN_INFO "%s: Initializing...\n", DEVICE_NAME);
 
+    if (!initial_factor || initial_factor > DEFAULT_MAX_RESOURCE_FACTOR) {
+        printk(KERN_ALERT "%s: initial_factor must be 1-%d\n", DEVICE_NAME, DEFAULT_MAX_RESOURCE_FACTOR);
+        return -EINVAL;
+    }
+    adjust_cfg_default.initial_factor = initial_factor;
+
     // Initialize global state
     memset(&monitor_state, 0, sizeof(monitor_state));
-    monitor_state.resource_allocation_factor = 5;
+    monitor_state.resource_allocation_factor = initial_factor;
     monitor_state.current_sim_workload_level = 0;
     monitor_state.simulated_gpu_temp = 50;
     monitor_state.simulated_memory_pressure = 0;
@@ -388,11 +6323,79 @@ static int __init auto_monitor_init(void)
     }
     printk(KERN_INFO "%s: Sysfs attributes created under /sys/kernel/%s/\n", DEVICE_NAME, DEVICE_NAME);
 
+    // Initialize metric sources (each adds its own Sysfs group)
+    ret = monitor_sources_init();
+    if (ret) {
+        sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
+        kobject_put(auto_monitor_kobj);
+        device_destroy(auto_monitor_class, MKDEV(major_number, 0));
+        class_destroy(auto_monitor_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        return ret;
+    }
+    printk(KERN_INFO "%s: Metric sources initialized\n", DEVICE_NAME);
+
+    // Register the built-in adjustment policies and their Sysfs group
+    ret = monitor_policies_init();
+    if (ret) {
+        printk(KERN_ALERT "%s: Failed to register adjustment policies\n", DEVICE_NAME);
+        monitor_sources_exit(ARRAY_SIZE(monitor_sources));
+        sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
+        kobject_put(auto_monitor_kobj);
+        device_destroy(auto_monitor_class, MKDEV(major_number, 0));
+        class_destroy(auto_monitor_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        return ret;
+    }
+    ret = sysfs_create_group(auto_monitor_kobj, &policy_attr_group);
+    if (ret) {
+        printk(KERN_ALERT "%s: Failed to create policy sysfs group\n", DEVICE_NAME);
+        monitor_policies_exit();
+        monitor_sources_exit(ARRAY_SIZE(monitor_sources));
+        sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
+        kobject_put(auto_monitor_kobj);
+        device_destroy(auto_monitor_class, MKDEV(major_number, 0));
+        class_destroy(auto_monitor_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        return ret;
+    }
+    ret = sysfs_create_group(auto_monitor_kobj, &config_attr_group);
+    if (ret) {
+        printk(KERN_ALERT "%s: Failed to create config sysfs group\n", DEVICE_NAME);
+        sysfs_remove_group(auto_monitor_kobj, &policy_attr_group);
+        monitor_policies_exit();
+        monitor_sources_exit(ARRAY_SIZE(monitor_sources));
+        sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
+        kobject_put(auto_monitor_kobj);
+        device_destroy(auto_monitor_class, MKDEV(major_number, 0));
+        class_destroy(auto_monitor_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        return ret;
+    }
+    ret = sysfs_create_group(auto_monitor_kobj, &alert_attr_group);
+    if (ret) {
+        printk(KERN_ALERT "%s: Failed to create alerts sysfs group\n", DEVICE_NAME);
+        sysfs_remove_group(auto_monitor_kobj, &config_attr_group);
+        sysfs_remove_group(auto_monitor_kobj, &policy_attr_group);
+        monitor_policies_exit();
+        monitor_sources_exit(ARRAY_SIZE(monitor_sources));
+        sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
+        kobject_put(auto_monitor_kobj);
+        device_destroy(auto_monitor_class, MKDEV(major_number, 0));
+        class_destroy(auto_monitor_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        return ret;
+    }
 
     // Initialize and start Workqueue
     monitor_wq = create_singlethread_workqueue(DEVICE_NAME);
     if (!monitor_wq) {
         printk(KERN_ALERT "%s: Failed to create workqueue\n", DEVICE_NAME);
+        sysfs_remove_group(auto_monitor_kobj, &alert_attr_group);
+        sysfs_remove_group(auto_monitor_kobj, &config_attr_group);
+        sysfs_remove_group(auto_monitor_kobj, &policy_attr_group);
+        monitor_policies_exit();
+        monitor_sources_exit(ARRAY_SIZE(monitor_sources));
         sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
         kobject_put(auto_monitor_kobj);
         device_destroy(auto_monitor_class, MKDEV(major_number, 0));
@@ -422,12 +6425,23 @@ static void __exit auto_monitor_exit(void)
     hrtimer_cancel(&monitor_hrtimer);
     printk(KERN_INFO "%s: HRTimer stopped.\n", DEVICE_NAME);
 
+    // Wait for any pending monitor work before tearing down the state it uses
+    cancel_work_sync(&monitor_work);
+
     // Destroy Workqueue
     if (monitor_wq) {
         destroy_workqueue(monitor_wq);
         printk(KERN_INFO "%s: Workqueue destroyed.\n", DEVICE_NAME);
     }
 
+    // Release policies and metric sources and their Sysfs groups
+    sysfs_remove_group(auto_monitor_kobj, &alert_attr_group);
+    sysfs_remove_group(auto_monitor_kobj, &config_attr_group);
+    sysfs_remove_group(auto_monitor_kobj, &policy_attr_group);
+    monitor_policies_exit();
+    monitor_sources_exit(ARRAY_SIZE(monitor_sources));
+    printk(KERN_INFO "%s: Metric sources released.\n", DEVICE_NAME);
+
     // Remove Sysfs attributes and kobject
     sysfs_remove_group(auto_monitor_kobj, &auto_monitor_attr_group);
     kobject_put(auto_monitor_kobj);
@@ -443,6 +6457,11 @@ static void __exit auto_monitor_exit(void)
     unregister_chrdev(major_number, DEVICE_NAME);
     printk(KERN_INFO "%s: Character device unregistered.\n", DEVICE_NAME);
 
+    // Nothing can reach the loaded model or the configuration any more (no work, no ioctls, no Sysfs)
+    kfree(rcu_dereference_protected(active_model, 1));
+    if (rcu_access_pointer(adjust_cfg) != &adjust_cfg_default)
+        kfree(rcu_dereference_protected(adjust_cfg, 1));
+
     printk(KERN_INFO "%s: Module unloaded.\n", DEVICE_NAME);
 }
 
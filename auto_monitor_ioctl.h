@@ -0,0 +1,230 @@
+// Shared between the auto_health_monitor module and user-space (app.c)
+// ioctl interface of /dev/auto_monitor
+#ifndef AUTO_MONITOR_IOCTL_H
+#define AUTO_MONITOR_IOCTL_H
+
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+#define AUTO_MONITOR_IOC_MAGIC 0xAD
+
+// Per-cgroup tracking
+#define AUTO_MONITOR_CGROUP_PATH_LEN 128
+
+struct auto_monitor_cgroup_stat {
+    __u64 id;                   // cgroup id (inode number of the cgroup directory)
+    __u64 cpu_usage_ns;         // Total CPU time consumed by the cgroup
+    __u64 memory_bytes;         // Current memory usage (0 if the memory controller is not enabled for it)
+    __u32 cpu_pct;              // CPU usage over the last interval (% of one CPU, can exceed 100)
+    __u32 psi_cpu_some;         // PSI "some" avg10, x100 (e.g. 1234 = 12.34%)
+    __u32 psi_memory_some;
+    __u32 psi_io_some;
+    __u32 resource_factor;      // Per-cgroup resource allocation factor (1-max_factor)
+    __u32 reserved;
+    char path[AUTO_MONITOR_CGROUP_PATH_LEN];   // Path relative to the cgroup2 mount
+};
+
+struct auto_monitor_cgroup_list {
+    __u32 capacity;             // in: number of entries the buffer can hold
+    __u32 count;                // out: number of entries copied
+    __u32 total;                // out: number of cgroups currently tracked
+    __u32 reserved;
+    __u64 entries;              // in: user pointer to capacity * struct auto_monitor_cgroup_stat
+};
+
+// List all tracked cgroups
+#define AUTO_MONITOR_IOC_CGROUP_LIST _IOWR(AUTO_MONITOR_IOC_MAGIC, 1, struct auto_monitor_cgroup_list)
+// Look up one cgroup by id (id in, full record out)
+#define AUTO_MONITOR_IOC_CGROUP_GET _IOWR(AUTO_MONITOR_IOC_MAGIC, 2, struct auto_monitor_cgroup_stat)
+
+// Registered-PID watch list
+#define AUTO_MONITOR_WATCH_COMM_LEN 16
+
+struct auto_monitor_watch_stat {
+    __s32 pid;                  // Process (thread group) id as registered
+    __u32 alive;                // 0 once the process has exited (entry stays until unregistered)
+    __u64 cpu_time_ns;          // Total CPU time of all threads
+    __u64 run_delay_ns;         // Total time spent runnable but waiting on a run queue
+    __u64 nvcsw;                // Voluntary context switches
+    __u64 nivcsw;               // Involuntary context switches (preemptions)
+    __u32 cpu_pct;              // Over the last interval, % of one CPU (can exceed 100)
+    __u32 starvation_pct;       // Run-queue wait over the last interval, % of the interval (0-100)
+    __u32 nvcsw_ps;             // Voluntary switches per second
+    __u32 nivcsw_ps;            // Involuntary switches per second
+    char comm[AUTO_MONITOR_WATCH_COMM_LEN];
+};
+
+struct auto_monitor_watch_list {
+    __u32 capacity;             // in: number of entries the buffer can hold
+    __u32 count;                // out: number of entries copied
+    __u32 total;                // out: number of registered PIDs
+    __u32 reserved;
+    __u64 entries;              // in: user pointer to capacity * struct auto_monitor_watch_stat
+};
+
+// Register / unregister a PID (resolved in the caller's PID namespace)
+#define AUTO_MONITOR_IOC_WATCH_ADD _IOW(AUTO_MONITOR_IOC_MAGIC, 3, __s32)
+#define AUTO_MONITOR_IOC_WATCH_DEL _IOW(AUTO_MONITOR_IOC_MAGIC, 4, __s32)
+// List all registered PIDs with their latest sample
+#define AUTO_MONITOR_IOC_WATCH_LIST _IOWR(AUTO_MONITOR_IOC_MAGIC, 5, struct auto_monitor_watch_list)
+
+// Application-reported SLO signals
+#define AUTO_MONITOR_SLO_NAME_LEN 32
+
+struct auto_monitor_slo_report {
+    char name[AUTO_MONITOR_SLO_NAME_LEN];  // Reporter name, reports with the same name are aggregated (empty = "pid:<tgid>")
+    __u32 window_ms;            // Length of the window the numbers cover
+    __u32 p50_us;               // Median latency over the window
+    __u32 p99_us;               // 99th percentile latency over the window
+    __u32 reserved;
+    __u64 requests;             // Requests completed in the window
+};
+
+// Publish one window of latency/throughput
+#define AUTO_MONITOR_IOC_SLO_REPORT _IOW(AUTO_MONITOR_IOC_MAGIC, 6, struct auto_monitor_slo_report)
+
+// Shared-memory metric ring
+// One single-producer/single-consumer ring per open file: create it with AUTO_MONITOR_IOC_RING_CREATE,
+// mmap() the returned size at offset 0, then push records with plain stores (see auto_monitor_ring_push()).
+// The kernel drains rings from its work handler and folds them into the SLO reports under the ring's name.
+#define AUTO_MONITOR_RING_BACKPRESSURE 0x1     // Ring is filling faster than it drains, producer should slow down
+
+enum auto_monitor_metric_kind {
+    AUTO_MONITOR_METRIC_LATENCY_US = 1,     // value = latency of one completed request (us)
+    AUTO_MONITOR_METRIC_REQUESTS = 2,       // value = number of requests completed (no latency attached)
+};
+
+struct auto_monitor_metric_record {
+    __u32 kind;                 // enum auto_monitor_metric_kind
+    __u32 reserved;
+    __u64 value;
+};
+
+struct auto_monitor_ring_header {
+    // Producer cache line
+    __u32 head;                 // Next slot to write (free-running, producer-owned)
+    __u32 reserved0;
+    __u64 overflow;             // Records the producer dropped because the ring was full (producer-owned)
+    __u8 pad0[48];
+    // Kernel cache line
+    __u32 tail;                 // Next slot the kernel will consume (free-running, kernel-owned)
+    __u32 flags;                // AUTO_MONITOR_RING_* (kernel-owned)
+    __u64 consumed;             // Records drained by the kernel
+    __u64 invalid;              // Records dropped by the kernel (unknown kind, corrupt indices)
+    __u32 capacity;             // Number of record slots (power of two)
+    __u32 records_offset;       // Byte offset of the record array from the start of the mapping
+    __u8 pad1[32];
+};
+
+struct auto_monitor_ring_create {
+    char name[AUTO_MONITOR_SLO_NAME_LEN];  // in: reporter name used for the SLO aggregate
+    __u32 capacity;             // in: requested record slots (rounded up to a power of two)
+    __u32 reserved;
+    __u64 mmap_size;            // out: bytes to mmap() at offset 0
+};
+
+#define AUTO_MONITOR_IOC_RING_CREATE _IOWR(AUTO_MONITOR_IOC_MAGIC, 7, struct auto_monitor_ring_create)
+
+// Loadable model policy
+// A model blob is one header followed by either tree nodes (root = node 0) or one __s32 weight per
+// feature. Features are integers in the units noted below; tree thresholds compare with <= (go left).
+#define AUTO_MONITOR_MODEL_MAGIC 0x4c444d41         // "AMDL" little-endian
+#define AUTO_MONITOR_MODEL_VERSION 1
+#define AUTO_MONITOR_MODEL_MAX_NODES 1024
+#define AUTO_MONITOR_MODEL_LEAF 0xffff              // node.feature value marking a leaf
+
+enum auto_monitor_model_kind {
+    AUTO_MONITOR_MODEL_TREE = 1,            // Leaves hold the target resource factor
+    AUTO_MONITOR_MODEL_LINEAR = 2,          // Target factor (milli) = bias + (sum of weight * feature) >> shift
+};
+
+enum auto_monitor_model_feature {
+    AUTO_MONITOR_FEAT_WORKLOAD,             // % (filtered, including real resource saturation)
+    AUTO_MONITOR_FEAT_SIM_WORKLOAD,         // %
+    AUTO_MONITOR_FEAT_GPU_TEMP,             // Degrees Celsius
+    AUTO_MONITOR_FEAT_MEMORY_PRESSURE,      // %
+    AUTO_MONITOR_FEAT_IO_UTILIZATION,       // %
+    AUTO_MONITOR_FEAT_NET_UTILIZATION,      // %
+    AUTO_MONITOR_FEAT_IRQ_LOAD,             // %
+    AUTO_MONITOR_FEAT_STEAL_TIME,           // %
+    AUTO_MONITOR_FEAT_RECLAIM_PRESSURE,     // %
+    AUTO_MONITOR_FEAT_WATCH_STARVATION,     // %
+    AUTO_MONITOR_FEAT_SLO_P99_US,           // us, 0 = no fresh reports
+    AUTO_MONITOR_FEAT_SLO_THROUGHPUT,       // Requests/s
+    AUTO_MONITOR_FEAT_LOAD_RATE,            // milli-% per timer period
+    AUTO_MONITOR_FEAT_RESOURCE_FACTOR,      // Current factor
+    AUTO_MONITOR_FEAT_COUNT,
+};
+
+struct auto_monitor_model_header {
+    __u32 magic;                // AUTO_MONITOR_MODEL_MAGIC
+    __u16 version;              // AUTO_MONITOR_MODEL_VERSION
+    __u16 kind;                 // enum auto_monitor_model_kind
+    __u32 count;                // Tree: number of nodes. Linear: number of weights (<= AUTO_MONITOR_FEAT_COUNT)
+    __u32 shift;                // Linear: fractional bits of the weights (0-31)
+    __s64 bias;                 // Linear: output offset in milli-factor, within +/-AUTO_MONITOR_FACTOR_LIMIT * 1000
+};
+
+struct auto_monitor_model_node {
+    __u16 feature;              // enum auto_monitor_model_feature, or AUTO_MONITOR_MODEL_LEAF
+    __u16 reserved;
+    __s32 threshold;            // Go to left if feature <= threshold, else right
+    __u32 left, right;          // Child node indices, must be greater than this node's index
+    __s32 value;                // Leaf: target resource factor
+};
+
+struct auto_monitor_model_load {
+    __u64 data;                 // in: user pointer to the blob
+    __u32 size;                 // in: blob size in bytes (0 = unload the current model)
+    __u32 reserved;
+};
+
+// Validate and atomically replace the model used by the "model" policy
+#define AUTO_MONITOR_IOC_MODEL_LOAD _IOW(AUTO_MONITOR_IOC_MAGIC, 8, struct auto_monitor_model_load)
+
+// Runtime configuration
+// AUTO_MONITOR_IOC_CONFIG_SET changes the fields selected in "set" in one step: the result is validated as a
+// whole (low_threshold < high_threshold <= 100, 1 <= initial_factor <= max_factor <= AUTO_MONITOR_FACTOR_LIMIT)
+// and either published entirely or rejected with -EINVAL. Both ioctls return the configuration in effect.
+#define AUTO_MONITOR_FACTOR_LIMIT 64
+
+#define AUTO_MONITOR_CONFIG_HIGH_THRESHOLD 0x1
+#define AUTO_MONITOR_CONFIG_LOW_THRESHOLD 0x2
+#define AUTO_MONITOR_CONFIG_MAX_FACTOR 0x4
+#define AUTO_MONITOR_CONFIG_INITIAL_FACTOR 0x8
+
+struct auto_monitor_config {
+    __u32 set;                  // in: AUTO_MONITOR_CONFIG_* fields to change (CONFIG_SET only)
+    __u32 high_threshold;       // Scale up above this workload (%)
+    __u32 low_threshold;        // Scale down below this workload (%)
+    __u32 max_factor;           // Largest resource factor the adjuster applies
+    __u32 initial_factor;       // Factor newly tracked cgroups start at (the module's own only at load)
+    __u32 reserved;
+    __u64 generation;           // out: bumped by every published change
+};
+
+#define AUTO_MONITOR_IOC_CONFIG_GET _IOR(AUTO_MONITOR_IOC_MAGIC, 9, struct auto_monitor_config)
+#define AUTO_MONITOR_IOC_CONFIG_SET _IOWR(AUTO_MONITOR_IOC_MAGIC, 10, struct auto_monitor_config)
+
+#ifndef __KERNEL__
+// Producer side: returns 0 on success, -1 if the ring was full (counted in header->overflow)
+static inline int auto_monitor_ring_push(struct auto_monitor_ring_header *hdr, __u32 kind, __u64 value)
+{
+    struct auto_monitor_metric_record *records =
+        (struct auto_monitor_metric_record *)((char *)hdr + hdr->records_offset);
+    __u32 head = hdr->head;
+    __u32 tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= hdr->capacity) {
+        hdr->overflow++;
+        return -1;
+    }
+    records[head & (hdr->capacity - 1)].kind = kind;
+    records[head & (hdr->capacity - 1)].value = value;
+    // Publish the record before the new head
+    __atomic_store_n(&hdr->head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+// Adjustment policy interface of the auto_health_monitor module
+// Built-in policies and policies in other modules register through the same API. Build external
+// modules with KBUILD_EXTRA_SYMBOLS pointing at this module's Module.symvers.
+#ifndef AUTO_MONITOR_POLICY_H
+#define AUTO_MONITOR_POLICY_H
+
+#include <linux/ktime.h>
+#include <linux/list.h>
+#include <linux/module.h>
+
+// What became of the previous run's decision
+enum monitor_outcome {
+    MONITOR_OUTCOME_APPLIED,            // Applied, or no change was asked for
+    MONITOR_OUTCOME_DEFERRED,           // Held back by the dwell time or the cooldown, may apply later
+    MONITOR_OUTCOME_OVERRIDDEN,         // Held by the steal guard, or the factor was changed outside the handler
+};
+
+// One snapshot of every signal, taken by the work handler each run
+struct monitor_inputs {
+    ktime_t now;
+    unsigned long workload;             // 0-100, simulated workload raised by saturated real resources, smoothed
+    unsigned long raw_workload;         // Same before smoothing
+    long load_rate;                     // Filtered load trend, milli-% per timer period (Kalman filter only)
+    unsigned long load_stddev;          // Uncertainty of the filtered load, milli-% (0 = not estimated)
+    unsigned long sim_workload;         // 0-100, simulated workload alone
+    unsigned long gpu_temp;             // Simulated temperature (degrees Celsius)
+    unsigned long memory_pressure;      // 0-100, simulated
+    unsigned long io_utilization;
+    unsigned long net_utilization;
+    unsigned long irq_load;
+    unsigned long steal_time;
+    unsigned long reclaim_pressure;
+    unsigned long watch_starvation;
+    unsigned long slo_p99_us;           // 0 = no fresh reports
+    unsigned long slo_throughput;       // Requests/s over fresh reports
+    unsigned long resource_factor;      // Current factor (1-max_factor)
+    unsigned long max_factor;           // Runtime configuration in effect for this run
+    unsigned long high_threshold;       // Workload band, %
+    unsigned long low_threshold;
+    enum monitor_outcome last_outcome;  // Of the previous run's decision, whichever policy made it
+};
+
+// observe, reset, decide and stats are serialized with each other and with the work handler.
+// observe, reset and decide run inside an RCU read-side section and must not sleep.
+struct monitor_policy {
+    const char *name;
+    struct module *owner;               // THIS_MODULE for policies in other modules, pinned while active
+    int (*init)(void);                                      // Optional, at registration
+    void (*exit)(void);                                     // Optional, after unregistration
+    void (*observe)(const struct monitor_inputs *in);       // Optional, called every run even when inactive
+    void (*reset)(const struct monitor_inputs *in);         // Optional, first run after becoming active
+    unsigned long (*decide)(const struct monitor_inputs *in);   // Returns the next resource factor (clamped by the core)
+    int (*stats)(char *buf, size_t size);                   // Optional, text stats, returns bytes written
+    struct list_head list;              // Registry link, owned by the core
+};
+
+// BPF struct_ops "auto_monitor_ops" behind the built-in "bpf" policy. decide returns the next resource
+// factor, or 0 to let the step policy decide.
+struct auto_monitor_ops {
+    unsigned long (*decide)(const struct monitor_inputs *in);
+    char name[16];
+};
+
+int auto_monitor_register_policy(struct monitor_policy *policy);
+void auto_monitor_unregister_policy(struct monitor_policy *policy);
+
+#endif